@@ -0,0 +1,95 @@
+#include <RotEncoder.h>
+
+// Decoder benchmark, drives the decoders with synthetic quadrature waveforms, no encoder needed:
+//
+//   Each decoder runs in a simulated encoder, where rdPins() returns the next state of a waveform and the pull-up functions
+//   do nothing. intr() is called once per edge, the same as from the interrupt vector. Each waveform turns a number of
+//   cycles up and the same number down, and the result shows the counts up, the counts at the end (0 if no counts are
+//   lost), and the time per edge of the clean waveform with the maximum edge rate it gives.
+//
+//   The time does not include reading the pins and the interrupt entry and exit, measured in the same intr() as on pins.
+
+// Setup Standard Output for Serial Print
+auto& Stdout = Serial;                                                                                  // Uses Serial as Stdout
+
+template <class Decoder>
+class SimEncoder : public RotEncoderT<SimEncoder<Decoder>, Decoder> {                                   // Encoder with pins from a waveform
+public:
+  void edge(uint8_t p) { pins = p; this->intr(); }                                                      // New state of pins, runs interrupt handler
+  inline uint8_t rdPins() __attribute__((always_inline)) { return pins; }                               // Reads simulated pins
+  inline void enPinA() __attribute__((always_inline)) { }                                               // No pull-ups to change
+  inline void enPinB() __attribute__((always_inline)) { }
+  inline void diPinA() __attribute__((always_inline)) { }
+  inline void diPinB() __attribute__((always_inline)) { }
+
+private:
+  volatile uint8_t pins = 0;                                                                            // State of simulated pins, bit 1 = PinA, bit 0 = PinB
+};
+
+enum Wave : uint8_t { Clean, Contact, Common, Missed };                                                 // Waveforms
+const char* const waveName[] = { "clean", "contact bounce", "common bounce", "missed edges" };
+const uint8_t InA = RotEncoderDecoder::PinA, InB = RotEncoderDecoder::PinB;
+const uint8_t upSeq[4] = { 0, InB, InA | InB, InA };                                                    // Up sequence, bit 1 = PinA, bit 0 = PinB
+const uint16_t cycles = 500;                                                                            // Cycles up, then down
+
+template <class Decoder>
+void run(Wave wave, long& up, long& end, uint32_t& us) {                                                // Runs one waveform in a new encoder
+  SimEncoder<Decoder> enc;
+  uint8_t s = 0;                                                                                        // Position in up sequence
+  uint32_t t = micros();
+  for (uint8_t dir = 1; dir <= 3; dir += 2) {                                                           // dir = 1 up, 3 down (-1 mod 4)
+    for (uint16_t n = 0; n < 4 * cycles; n++) {
+      uint8_t last = upSeq[s];
+      s = (s + dir) & 3;
+      if ((wave == Missed) && ((n & 15) == 7)) continue;                                                // Edge lost, every 16th quarter step
+      enc.edge(upSeq[s]);
+      if (wave == Contact) { enc.edge(last); enc.edge(upSeq[s]); }                                      // Changed switch bounces once
+      if ((wave == Common) && (upSeq[s] != 0)) { enc.edge(0); enc.edge(upSeq[s]); }                     // Common pin bounces, all closed switches open
+    }
+    if (dir == 1) up = enc.getPosition();
+  }
+  us = micros() - t;
+  end = enc.getPosition();
+}
+
+template <class Decoder>
+void bench(const char* name, uint8_t res) {                                                             // Prints results of all waveforms for decoder
+  Stdout.print(name);
+  Stdout.print(" (expect ");
+  Stdout.print((long)cycles * res);
+  Stdout.println(" up, 0 at end)");
+  for (uint8_t w = Clean; w <= Missed; w++) {
+    long up, end;
+    uint32_t us;
+    run<Decoder>((Wave)w, up, end, us);
+    Stdout.print("  ");
+    Stdout.print(waveName[w]);
+    Stdout.print(": up ");
+    Stdout.print(up);
+    Stdout.print(", end ");
+    Stdout.print(end);
+    if (w == Clean) {                                                                                   // Time per edge from the clean waveform
+      uint32_t edges = 8UL * cycles;
+      Stdout.print(", ");
+      Stdout.print((float)us / edges, 2);
+      Stdout.print(" us/edge, max ");
+      Stdout.print(edges * 1000UL / us);
+      Stdout.print(" kHz");
+    }
+    Stdout.println();
+  }
+}
+
+void setup() {
+  Stdout.begin(115200);                                                                                 // Initialize Serial communication
+  while (!Stdout);
+  Stdout.println("Rotary Encoder Decoder Benchmark");
+  bench<RotEncoderStdDecoder>("RotEncoderStdDecoder", 1);
+  bench<RotEncoderTableDecoder>("RotEncoderTableDecoder", 1);
+  bench<RotEncoderQuadDecoder<2> >("RotEncoderQuadDecoder<2>", 2);
+  bench<RotEncoderQuadDecoder<4> >("RotEncoderQuadDecoder<4>", 4);
+  bench<RotEncoderQuadDecoder<4, true> >("RotEncoderQuadDecoder<4, true>", 4);                          // Lost steps inferred from last direction
+}
+
+void loop() {
+}
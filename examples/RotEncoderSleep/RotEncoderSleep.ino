@@ -0,0 +1,38 @@
+#include <RotEncoder.h>
+
+// Setup Standard Output for Serial Print
+auto& Stdout = Serial;                                                                                  // Uses Serial as Stdout
+
+class Knob : public RotEncoderPinsT<2, 3, RotEncoderStdDecoder, Knob> {                                 // Encoder on pin 2 and 3
+public:
+  void onStep(int8_t) { RotEncoderWake::notify(); }                                                     // Wake main loop after each step
+};
+
+Knob knob;                                                                                              // Make an instance of Knob
+
+void setup() {
+  Stdout.begin(115200);                                                                                 // Initialize Serial communication
+  while (!Stdout);
+  Stdout.println("Rotary Encoder Sleep Example");
+  if (knob.begin()) {                                                                                   // Start rotary encoder
+    Stdout.println("Rotary Encoder Running");
+  } else {
+    Stdout.println("Interrupt setup failed.");
+  }
+}
+
+void loop() {
+  Stdout.flush();                                                                                       // Send all output before sleep
+#if defined(__AVR__)
+  if (knob.prepareSleep()) {                                                                            // Wake on the pins that have pull-up on
+    RotEncoderWake::sleep(SLEEP_MODE_PWR_DOWN);                                                         // Deep sleep until the knob is turned
+  } else {
+    RotEncoderWake::sleep(SLEEP_MODE_IDLE);                                                             // Both switches closed, idle until next step
+  }
+  knob.resumeFromSleep();                                                                               // Back to CHANGE interrupts
+#else
+  RotEncoderWake::sleep();                                                                              // Sleep until the knob is turned
+#endif
+  Stdout.print("Position = ");
+  Stdout.println(knob.getPosition());
+}
@@ -0,0 +1,138 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderBench.cpp                                                                                                       //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+// Host benchmark and test of the decoders, run by make in extras/test:
+//
+//   Each decoder runs in a simulated encoder, where rdPins() returns the next state of a waveform and the pull-up functions
+//   do nothing. intr() is called once per edge, the same as from the interrupt vector. RotEncoderBank runs three encoders
+//   on PORTD, driven through the simulated PIND register and its pin change vector. Each waveform turns a number of cycles
+//   up and the same number down. The counts up and the counts at the end are compared with the expected counts, and the
+//   program exits with 1 if any differ. The edge rate of the clean waveform is printed for each decoder.
+
+#include <RotEncoder.h>
+#include <stdio.h>
+
+template <class Decoder>
+class SimEncoder : public RotEncoderT<SimEncoder<Decoder>, Decoder> {                                   // Encoder with pins from a waveform
+public:
+  void edge(uint8_t p) { pins = p; this->intr(); }                                                      // New state of pins, runs interrupt handler
+  inline uint8_t rdPins() __attribute__((always_inline)) { return pins; }                               // Reads simulated pins
+  inline void enPinA() __attribute__((always_inline)) { }                                               // No pull-ups to change
+  inline void enPinB() __attribute__((always_inline)) { }
+  inline void diPinA() __attribute__((always_inline)) { }
+  inline void diPinB() __attribute__((always_inline)) { }
+
+private:
+  volatile uint8_t pins = 0;                                                                            // State of simulated pins, bit 1 = PinA, bit 0 = PinB
+};
+
+typedef RotEncoderBank<RotEncoderPortD, 0x0C, 0x30, 0xC0> SimBank;                                      // D2/D3, D4/D5, D6/D7
+
+class SimBankEncoder {                                                                                  // All encoders of the bank get the same waveform
+public:
+  SimBankEncoder() { edge(0); bank.begin(); }
+  void edge(uint8_t p) {                                                                                // New state of pins, runs pin change vector
+    _SFR_IO8(RotEncoderPortIO<RotEncoderPortD>::pinReg) = ~((p << 2) | (p << 4) | (p << 6));            // Closed switch reads low
+    PCINT2_vect();
+  }
+  long getPosition() const {                                                                            // Position, only if all encoders agree
+    long p = bank.getPosition(0);
+    return ((bank.getPosition(1) == p) && (bank.getPosition(2) == p)) ? p : 0x7FFFFFFFL;
+  }
+
+private:
+  SimBank bank;
+};
+
+enum Wave : uint8_t { Clean, Contact, Common, Missed };                                                 // Waveforms
+const char* const waveName[] = { "clean", "contact bounce", "common bounce", "missed edges" };
+const uint8_t InA = RotEncoderDecoder::PinA, InB = RotEncoderDecoder::PinB;
+const uint8_t upSeq[4] = { 0, InB, InA | InB, InA };                                                    // Up sequence, bit 1 = PinA, bit 0 = PinB
+const long cycles = 500;                                                                                // Cycles up, then down
+const int repeat = 200;                                                                                 // Runs of the clean waveform for the edge rate
+
+struct Expect { long up, end; };                                                                        // Expected counts for one waveform
+
+template <class Enc>
+uint32_t run(Enc& enc, Wave wave, long& up, long& end) {                                                // Runs one waveform, returns number of edges
+  uint8_t s = 0;                                                                                        // Position in up sequence
+  uint32_t edges = 0;
+  for (uint8_t dir = 1; dir <= 3; dir += 2) {                                                           // dir = 1 up, 3 down (-1 mod 4)
+    for (long n = 0; n < 4 * cycles; n++) {
+      uint8_t last = upSeq[s];
+      s = (s + dir) & 3;
+      if ((wave == Missed) && ((n & 15) == 7)) continue;                                                // Edge lost, every 16th quarter step
+      enc.edge(upSeq[s]); edges++;
+      if (wave == Contact) { enc.edge(last); enc.edge(upSeq[s]); edges += 2; }                          // Changed switch bounces once
+      if ((wave == Common) && (upSeq[s] != 0)) { enc.edge(0); enc.edge(upSeq[s]); edges += 2; }         // Common pin bounces, all closed switches open
+    }
+    if (dir == 1) up = enc.getPosition();
+  }
+  end = enc.getPosition();
+  return edges;
+}
+
+template <class Enc>
+bool bench(const char* name, const Expect (&expect)[4]) {                                               // Checks all waveforms, prints edge rate
+  bool ok = true;
+  printf("%s\n", name);
+  for (uint8_t w = Clean; w <= Missed; w++) {
+    long up, end;
+    Enc enc;
+    run(enc, (Wave)w, up, end);
+    bool pass = (up == expect[w].up) && (end == expect[w].end);
+    printf("  %-15s up %6ld (expect %6ld), end %6ld (expect %6ld)  %s\n", waveName[w], up, expect[w].up, end, expect[w].end, pass ? "ok" : "FAIL");
+    ok = ok && pass;
+  }
+  uint32_t edges = 0;
+  unsigned long t = micros();
+  for (int i = 0; i < repeat; i++) {
+    long up, end;
+    Enc enc;
+    edges += run(enc, Clean, up, end);
+  }
+  t = micros() - t;
+  printf("  %.1f Medges/s\n", t ? (double)edges / t : 0.0);
+  return ok;
+}
+
+int main() {
+  const long c = cycles;                                                                                // Every 16th quarter step missed is a jump, 2 quarter steps lost
+  const Expect std1[4] = { { c, 0 }, { c, 0 }, { c, 0 }, { c, 0 } };                                    // 1 count per cycle, bounce and missed edges ignored
+  const Expect quad2[4] = { { 2 * c, 0 }, { 2 * c, 0 }, { 2 * c, 0 }, { 2 * c - c / 4, 0 } };           // 2 counts per cycle, jumps lose a count
+  const Expect quad4[4] = { { 4 * c, 0 }, { 4 * c, 0 }, { 4 * c, 0 }, { 4 * c - c / 2, 0 } };           // 4 counts per cycle, jumps lose two counts
+  const Expect infer[4] = { { 4 * c, 0 }, { 4 * c, 0 }, { 8 * c, 0 }, { 4 * c, 0 } };                   // Jumps inferred, also the common pin bounce
+  bool ok = true;
+  ok &= bench<SimEncoder<RotEncoderStdDecoder> >("RotEncoderStdDecoder", std1);
+  ok &= bench<SimEncoder<RotEncoderTableDecoder> >("RotEncoderTableDecoder", std1);
+  ok &= bench<SimEncoder<RotEncoderQuadDecoder<2> > >("RotEncoderQuadDecoder<2>", quad2);
+  ok &= bench<SimEncoder<RotEncoderQuadDecoder<4> > >("RotEncoderQuadDecoder<4>", quad4);
+  ok &= bench<SimEncoder<RotEncoderQuadDecoder<4, true> > >("RotEncoderQuadDecoder<4, true>", infer);
+  ok &= bench<SimBankEncoder>("RotEncoderBank, 3 encoders", std1);                                      // Same state machine as RotEncoderStdDecoder
+  printf("%s\n", ok ? "All decoders ok" : "Decoder test FAILED");
+  return ok ? 0 : 1;
+}
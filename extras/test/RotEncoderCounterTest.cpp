@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderCounterTest.cpp                                                                                                 //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+// Host test of the position counters and overflow policies, run by make in extras/test:
+//
+//   Each check prints the result and the expected value, and the program exits with 1 if any check fails.
+
+#include <RotEncoder.h>
+#include <stdio.h>
+
+static int failed = 0;
+
+template <class T>
+static void check(const char* what, T got, T expect) {                                                  // Compares and prints one result
+  bool ok = (got == expect);
+  printf("  %-40s %6ld (expect %6ld)  %s\n", what, (long)got, (long)expect, ok ? "ok" : "FAIL");
+  if (!ok) failed++;
+}
+
+template <class T>
+static T step(RotEncoderRangeCounter<T>& c, int8_t n) { c.add(n); return c.get(); }                     // Adds n, returns position
+
+template <class T>
+static void testRange(const char* name, T lo, T hi) {                                                   // Wrap and stop at both ends of range
+  printf("%s [%ld, %ld]\n", name, (long)lo, (long)hi);
+  RotEncoderRangeCounter<T> c;
+  c.setRange(lo, hi, true);
+  c.set(hi);
+  check("wrap: max + 1", step(c, 1), lo);
+  check("wrap: min - 1", step(c, -1), hi);
+  c.set(hi - 1);
+  check("wrap: max - 1 + 3", step(c, 3), (T)(lo + 1));
+  check("wrap: min + 1 - 3", step(c, -3), (T)(hi - 1));
+  c.set(lo);
+  check("wrap: min + 0", step(c, 0), lo);
+  c.setRange(lo, hi, false);
+  c.set(hi);
+  check("stop: max + 1", step(c, 1), hi);
+  check("stop: max - 1", step(c, -1), (T)(hi - 1));
+  c.set(lo);
+  check("stop: min - 1", step(c, -1), lo);
+  check("stop: min + 127", step(c, 127), (T)((long)hi - lo < 127 ? hi : lo + 127));
+}
+
+int main() {
+  testRange<uint8_t>("RotEncoderRangeCounter<uint8_t>", 0, 255);                                        // Ends at the limits of the type
+  testRange<int8_t>("RotEncoderRangeCounter<int8_t>", 0, 127);
+  testRange<int8_t>("RotEncoderRangeCounter<int8_t>", -128, 10);
+  testRange<int8_t>("RotEncoderRangeCounter<int8_t>", -128, 127);
+  testRange<long>("RotEncoderRangeCounter<long>", -5, 5);                                               // Ends inside the type
+  testRange<uint16_t>("RotEncoderRangeCounter<uint16_t>", 100, 65535);
+
+  printf("RotEncoderRangeCounter<int8_t> [0, 9], step larger than range\n");
+  RotEncoderRangeCounter<int8_t> c;
+  c.setRange(0, 9, true);
+  c.set(5);
+  check("wrap: 5 + 20 stops at max", step(c, 20), (int8_t)9);
+  c.set(5);
+  check("wrap: 5 - 20 stops at min", step(c, -20), (int8_t)0);
+  c.set(5);
+  check("wrap: 5 + 7", step(c, 7), (int8_t)2);
+
+  printf("RotEncoderRangeCounter<int8_t> [10, 20], exchange() from the end nearest to 0\n");
+  RotEncoderRangeCounter<int8_t> x;
+  x.setRange(10, 20, false);
+  x.set(15);
+  check("stop: exchange at 15", x.exchange(), (int8_t)5);
+  check("stop: position after exchange", x.get(), (int8_t)10);
+  x.add(3);
+  check("stop: exchange after +3", x.exchange(), (int8_t)3);
+  x.add(-1);
+  check("stop: exchange after -1 at min", x.exchange(), (int8_t)0);
+  x.setRange(10, 20, true);
+  x.add(-1);
+  check("wrap: exchange after -1 at min", x.exchange(), (int8_t)-1);
+  x.add(5);
+  check("wrap: exchange after +5", x.exchange(), (int8_t)5);
+  x.setRange(-20, -10, true);
+  x.set(-10);
+  x.add(1);
+  check("wrap: [-20, -10] max + 1", x.exchange(), (int8_t)1);
+  x.setRange(0, 9, true);
+  check("wrap: [0, 9] distance 9 to 0", x.distance(9, 0), (int8_t)1);
+  check("wrap: [0, 9] distance 0 to 9", x.distance(0, 9), (int8_t)-1);
+
+  printf("RotEncoderCounterT<int8_t>, wrap and saturate\n");
+  RotEncoderCounterT<int8_t> w;
+  w.set(127); w.add(1);
+  check("wrap: 127 + 1", w.get(), (int8_t)-128);
+  RotEncoderCounterT<int8_t, RotEncoderSaturate> s;
+  s.set(127); s.add(1);
+  check("saturate: 127 + 1", s.get(), (int8_t)127);
+  s.set(-128); s.add(-1);
+  check("saturate: -128 - 1", s.get(), (int8_t)-128);
+  RotEncoderCounterT<int8_t, RotEncoderClamp<-10, 10> > k;
+  k.set(10); k.add(1);
+  check("clamp: 10 + 1", k.get(), (int8_t)10);
+
+  printf("%s\n", failed ? "Counter test FAILED" : "All counters ok");
+  return failed ? 1 : 0;
+}
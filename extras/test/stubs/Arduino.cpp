@@ -0,0 +1,20 @@
+// Definitions for the host Arduino.h stub, see stubs/Arduino.h.
+
+#include <Arduino.h>
+#include <chrono>
+
+uint8_t simIO[64];
+uint8_t simPCICR;
+uint8_t simPCMSK[3];
+voidFuncPtr simVector[EXTERNAL_NUM_INTERRUPTS];
+
+void attachInterrupt(uint8_t n, voidFuncPtr f, int) { if (n < EXTERNAL_NUM_INTERRUPTS) simVector[n] = f; }
+void detachInterrupt(uint8_t n) { if (n < EXTERNAL_NUM_INTERRUPTS) simVector[n] = nullptr; }
+
+static unsigned long long hostMicros() {
+  using namespace std::chrono;
+  static const steady_clock::time_point start = steady_clock::now();
+  return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+unsigned long micros() { return (unsigned long)hostMicros(); }
+unsigned long millis() { return (unsigned long)(hostMicros() / 1000); }
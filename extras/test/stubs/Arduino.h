@@ -0,0 +1,86 @@
+// Minimal Arduino.h for host builds of the library tests, see extras/test/Makefile:
+//
+//   The tests are built with __AVR_ATmega328P__ defined, so the direct port I/O of RotEncoderIO.h and the pin change
+//   interrupts of RotEncoderPcint.h are compiled with the pin mapping of the Arduino Nano. __AVR__ is not defined, so the
+//   library uses its own ATOMIC_BLOCK() and micros() timestamps. The I/O space is an array, a test sets the PINx registers
+//   to the pin levels and calls the interrupt vectors directly. Interrupts are never disabled (single thread).
+
+#ifndef ARDUINO_STUB_H
+#define ARDUINO_STUB_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define LOW_LEVEL 0
+
+typedef void (*voidFuncPtr)(void);
+
+extern uint8_t simIO[64];                                                                               // I/O space, PINx, DDRx, PORTx
+#define _SFR_IO8(a) (simIO[(a)])
+#ifndef _BV
+  #define _BV(b) (1u << (b))
+#endif
+
+// Nano pin mapping: D0-D7 = PORTD (PIND 0x09), D8-D13 = PORTB (PINB 0x03), A0-A5 = PORTC (PINC 0x06)
+#define SIM_PIN_REG(p) ((p) < 8 ? 0x09 : ((p) < 14 ? 0x03 : 0x06))
+#define SIM_PIN_BIT(p) ((p) < 8 ? (p) : ((p) < 14 ? (p) - 8 : (p) - 14))
+
+inline int digitalRead(uint8_t p) { return (simIO[SIM_PIN_REG(p)] >> SIM_PIN_BIT(p)) & 1; }
+inline void digitalWrite(uint8_t p, uint8_t v) { if (v) simIO[SIM_PIN_REG(p) + 2] |= _BV(SIM_PIN_BIT(p)); else simIO[SIM_PIN_REG(p) + 2] &= ~_BV(SIM_PIN_BIT(p)); }
+inline void pinMode(uint8_t p, uint8_t m) {
+  if (m == OUTPUT) simIO[SIM_PIN_REG(p) + 1] |= _BV(SIM_PIN_BIT(p)); else simIO[SIM_PIN_REG(p) + 1] &= ~_BV(SIM_PIN_BIT(p));
+  if (m == INPUT_PULLUP) digitalWrite(p, HIGH);
+}
+
+#define NOT_AN_INTERRUPT -1
+#define EXTERNAL_NUM_INTERRUPTS 2
+#define digitalPinToInterrupt(p) ((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT))
+void attachInterrupt(uint8_t n, voidFuncPtr f, int mode);
+void detachInterrupt(uint8_t n);
+extern voidFuncPtr simVector[EXTERNAL_NUM_INTERRUPTS];                                                  // Attached external interrupt handlers
+
+inline void noInterrupts() { }
+inline void interrupts() { }
+inline void cli() { }
+inline void sei() { }
+
+unsigned long micros();                                                                                 // Host time
+unsigned long millis();
+inline void delayMicroseconds(unsigned int) { }
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+
+#define NOT_A_PIN 0
+#define digitalPinToPort(p) ((p) < 8 ? 4 : ((p) < 14 ? 2 : 3))                                         // PD, PB, PC as in the AVR core
+#define digitalPinToBitMask(p) _BV(SIM_PIN_BIT(p))
+#define portInputRegister(port) (&simIO[(port) == 4 ? 0x09 : ((port) == 2 ? 0x03 : 0x06)])
+#define portModeRegister(port) (portInputRegister(port) + 1)
+#define portOutputRegister(port) (portInputRegister(port) + 2)
+
+extern uint8_t simPCICR;                                                                                // Pin change interrupt registers
+extern uint8_t simPCMSK[3];
+#define PCICR simPCICR
+#define digitalPinToPCICR(p) ((p) < 20 ? &simPCICR : (uint8_t*)0)
+#define digitalPinToPCICRbit(p) ((p) < 8 ? 2 : ((p) < 14 ? 0 : 1))
+#define digitalPinToPCMSK(p) ((p) < 20 ? &simPCMSK[digitalPinToPCICRbit(p)] : (uint8_t*)0)
+#define digitalPinToPCMSKbit(p) SIM_PIN_BIT(p)
+
+#define ISR(v) extern "C" void v()                                                                      // Vectors are plain functions
+#define PCINT0_vect simPcint0
+#define PCINT1_vect simPcint1
+#define PCINT2_vect simPcint2
+extern "C" void simPcint0();
+extern "C" void simPcint1();
+extern "C" void simPcint2();
+
+#endif  // ARDUINO_STUB_H
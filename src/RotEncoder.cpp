@@ -27,75 +27,55 @@
 
 #include "RotEncoder.h"
 
-RotEncoder::IntHandleT RotEncoder::intHandle = NULL;                                                    // Initialize interrupt handle pointer to indicate no connection to class
+RotEncoderISR::IntHandleT RotEncoderISR::intHandle[ROTENCODER_NUM_INTERRUPTS] = {};                     // Initialize all interrupt handles to nullptr, no connection to any class
 
 
-bool RotEncoder::begin() {                                                                              // Start rotary encoder, returns true if successful
-  // Method to begin interrupt handling by setting up the static pointer and attaching the ISR
-  if (intHandle == nullptr) {                                                                           // Only start if the handler is not already set
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-      // Use atomic block for 8/16-bit systems. It ensures that interrupts are fully disabled during
-      // pointer assignment, providing safety in case previous detachInterrupt() wasn't called or failed.
-      intHandle = this;                                                                                 // Set the static pointer to the current instance
+bool RotEncoderISR::claim(int8_t intNum, void* handle) {                                                // Claim interrupt vector, returns true if successful
+  if ((intNum < 0) || (intNum >= ROTENCODER_NUM_INTERRUPTS)) return false;                              // Pin has no interrupt, or table too small
+  bool ok = false;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {                                                                   // Test and set must be atomic
+    if (intHandle[intNum] == nullptr) {                                                                 // Only claim vector if not used by other instance
+      intHandle[intNum] = handle;
+      ok = true;
     }
-    enPinA();                                                                                           // Enable PinA and PinB inputs with pull-up
-    enPinB();
-    attachInterrupt(digitalPinToInterrupt(getPinA()), isr, CHANGE);                                     // Attach interrupt for PinA, set to change pin
-    attachInterrupt(digitalPinToInterrupt(getPinB()), isr, CHANGE);                                     // Attach interrupt for PinB, set to change pin
-    return true;                                                                                        // Return true if ok
   }
-  return false;                                                                                         // Return false if intHandle is already set
+  return ok;
 }
 
-bool RotEncoder::end() {                                                                                // Stops interrupt handling, returns true if successful
-  // Method to stop interrupt handling by detaching the ISR and resetting the static pointer
-  if (intHandle == this) {  // Only stop if intHandle points to this instance
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-      // Use atomic block for 8/16-bit systems. If detachInterrupt() fails, this atomic block ensures
-      // intHandle is safely set to nullptr, preventing any invalid interrupt calls. Since detachInterrupt()
-      // doesn't return success/failure code, handling this carefully is important.
-      intHandle = nullptr;                                                                              // Remove handle to this class, set to nullptr
+bool RotEncoderISR::release(int8_t intNum, const void* handle) {                                        // Release interrupt vector, returns true if successful
+  if ((intNum < 0) || (intNum >= ROTENCODER_NUM_INTERRUPTS)) return false;                              // Not a valid interrupt number
+  bool ok = false;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    // Use atomic block for 8/16-bit systems. If detachInterrupt() fails, this atomic block ensures
+    // the handle is safely set to nullptr, preventing any invalid interrupt calls.
+    if (intHandle[intNum] == handle) {                                                                  // Only release if vector belongs to handle
+      intHandle[intNum] = nullptr;
+      ok = true;
     }
-    detachInterrupt(digitalPinToInterrupt(getPinA()));                                                  // Detach interrupt for PinA
-    detachInterrupt(digitalPinToInterrupt(getPinB()));                                                  // Detach interrupt for PinB
-    return true;                                                                                        // Return true if ok
   }
-  return false;                                                                                         // Return false if intHandle doesn't match this instance
+  return ok;
 }
 
-long RotEncoder::getPosition() const {                                                                  // Returns actual value from the rotary encoder
-  long pos;
-  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {                                                                   // Read position atomic
-    pos = position;
-  }
-  return pos;                                                                                           // and return it
-}
 
-void RotEncoder::intr() {                                                                               // Immplementation of interrupt handler for rotary encoder
-  cli();                                                                                                // No interrupts allowed during read
-  enPinA(); enPinB();                                                                                   // Uses built-in pull-ups
-  do {                                                                                                  // Read inputs, ensure stable valid readings
-    inA = rdPinA(); inB = rdPinB();                                                                     //   Read inputs
-  } while((inA!=rdPinA())||(inB!=rdPinB()));                                                            // Retry until stable
-
-  // This is code for rotary switch:
-  if (inA) {                                                                                            // Switch(inA,inB) case:
-    if (inB) {                                                                                          //   InA on and InB on:
-      cntflg = true;                                                                                    //     Set count flag
-    } else {                                                                                            //   InA on and InB off:
-      diPinA();                                                                                         //     Turn off pull-up current for inA
-      if ((!lrflg)&&cntflg) position++;                                                                 //     lrflg indicates if oposite position, cntflg to count up/dn
-      lrflg = true;                                                                                     //     Set lrflag to true for this position (SW1 on, SW0 off)
-      cntflg = false;                                                                                   //     Clear count flag
-    }
-  } else {
-    if (inB) {                                                                                          //   InA off and InB on:
-      diPinB();                                                                                         //     Turn off pull-up current for inA
-      if (lrflg&&cntflg) position--;                                                                    //     lrflg indicates if oposite position, cntflg to count up/dn
-      lrflg = false;                                                                                    //     Set lrflag to false for this position (SW1 off, SW0 on)
-      cntflg = false;                                                                                   //     Clear count flag
-    } else {                                                                                            //   InA off and InB off:
-    }                                                                                                   //     Do nothing. cntflg is false, unless bounce on common pin
-  }                                                                                                     //       (Do nothing: Bounceing on common pin is handled)
-  sei();
-}
+#ifdef ROTENCODER_PCINT
+bool (*RotEncoderPcint::attachFn)(uint8_t, void*, CallT) = nullptr;                                     // Pin change interrupts not enabled, set by RotEncoderPcint::enable()
+void (*RotEncoderPcint::detachFn)(const void*) = nullptr;
+#endif
+
+
+volatile bool RotEncoderWake::flag = false;                                                             // No step yet
+
+
+const uint8_t RotEncoderTableDecoder::table[16] PROGMEM = {                                             // Decoder table in flash, generated at compile time
+  entry( 0), entry( 1), entry( 2), entry( 3), entry( 4), entry( 5), entry( 6), entry( 7),
+  entry( 8), entry( 9), entry(10), entry(11), entry(12), entry(13), entry(14), entry(15)
+};
+
+
+const uint8_t RotEncoderQuadTable::table[16] PROGMEM = {                                                // Quarter step table in flash, generated at compile time
+  entry( 0), entry( 1), entry( 2), entry( 3), entry( 4), entry( 5), entry( 6), entry( 7),
+  entry( 8), entry( 9), entry(10), entry(11), entry(12), entry(13), entry(14), entry(15)
+};
+
+
+template class RotEncoderT<RotEncoder>;                                                                 // Instantiate the core for RotEncoder once
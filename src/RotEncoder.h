@@ -29,7 +29,24 @@
 #define ROTENCODER_H
 
 #include <Arduino.h>
-#include <util/atomic.h>  // Include atomic utility for critical sections. Required for 8/16-bit systems to ensure atomic operations
+#include "RotEncoderAtomic.h"  // Include atomic utility for critical sections. Required for 8/16-bit systems to ensure atomic operations
+#include "RotEncoderIO.h"  // Direct port I/O for pins known at compile time
+#include "RotEncoderDecoder.h"  // Decoders for the rotary encoder state machine
+#include "RotEncoderCounter.h"  // Position counter with lock-free read
+#include "RotEncoderClock.h"  // Cheap timestamps for the interrupt handler
+#include "RotEncoderStats.h"  // Opt-in statistics of the interrupt handler
+#include "RotEncoderEvents.h"  // Event ring buffer from the interrupt handler to the main loop
+#include "RotEncoderVelocity.h"  // Velocity and acceleration from step timestamps
+#include "RotEncoderAccel.h"  // Speed dependent acceleration of position increments
+#include "RotEncoderHw.h"  // Hardware quadrature decoder backend for 32-bit targets
+#include "RotEncoderSampler.h"  // Timer sampled encoders, for pins without external interrupts
+#include "RotEncoderPcint.h"  // Pin change interrupts on AVR, for pins without external interrupts
+#include "RotEncoderBank.h"  // Bank of encoders on one port, decoded together
+#include "RotEncoderWake.h"  // Wake the main loop when an encoder moves
+#include "RotEncoderStore.h"  // Position stored in EEPROM, wear leveled
+#include "RotEncoderCapture.h"  // Timestamped edges by Timer1 input capture
+#include "RotEncoderDispatch.h"  // Position changes fanned out to listeners in the main loop
+#include "RotEncoderGroup.h"  // Positions of several encoders at one instant
 
 // Rotary Encoder Pin Connections to Arduino Nano:
 //
@@ -44,17 +61,163 @@
 //   - This setup assumes the encoder uses open-drain/open-collector outputs (actively pulls low, never high).
 //   - If your encoder drives pins high, modify or override the code to prevent conflicts.
 
-class RotEncoder {                                                                                      // Interface for RotEncoder
+#ifdef ROTENCODER_NUM_INTERRUPTS                                                                        // Table is in RotEncoder.cpp, a sketch define would not resize it
+  #error "ROTENCODER_NUM_INTERRUPTS is set from the core, it can not be defined by the sketch"
+#elif defined(EXTERNAL_NUM_INTERRUPTS)                                                                  // Size of interrupt dispatch table: Number of external interrupts from core if known
+  #define ROTENCODER_NUM_INTERRUPTS EXTERNAL_NUM_INTERRUPTS
+#elif defined(__AVR__)                                                                                  //   AVR: Max. 8 external interrupts (ATmega2560)
+  #define ROTENCODER_NUM_INTERRUPTS 8
+#elif defined(NUM_DIGITAL_PINS)                                                                         //   32-bit: Interrupt number is normally the pin number
+  #define ROTENCODER_NUM_INTERRUPTS NUM_DIGITAL_PINS
+#else
+  #define ROTENCODER_NUM_INTERRUPTS 32
+#endif
+
+#ifndef NOT_AN_INTERRUPT
+  #define NOT_AN_INTERRUPT -1                                                                           // Returned by digitalPinToInterrupt() if pin has no interrupt
+#endif
+
+// Interrupt dispatch table shared by all rotary encoders:
+//
+//   Each interrupt vector has its own static trampoline isr<T,N>(), generated by template, that reads the instance pointer
+//   from slot N in the table and calls intr() directly in the instance type T. There is no search at interrupt time and no
+//   shared handle, so the interrupt latency stays the same for one encoder or many encoders.
+
+class RotEncoderISR {                                                                                   // Interrupt dispatch table for all encoder instances
+public:
+  typedef void (*IsrT)();                                                                               // Function pointer type for attachInterrupt()
+  static bool claim(int8_t intNum, void* handle);                                                       // Claim interrupt vector for handle, returns true if successful
+  static bool release(int8_t intNum, const void* handle);                                               // Release interrupt vector, returns true if owned by handle
+  template <class T> static IsrT vector(uint8_t intNum) { return Vector<T>::get(intNum); }              // Returns trampoline for interrupt vector
+  template <class T> static IsrT wakeVector(uint8_t intNum) { return WakeVector<T>::get(intNum); }      // Returns trampoline for wake from sleep on LOW level
+  template <class T> static void call(void* handle) { static_cast<T*>(handle)->intr(); }                // Calls intr() in instance type T, for shared vectors
+
+private:
+  typedef void* volatile IntHandleT;                                                                    // Pointer to instance for interrupts
+  static IntHandleT intHandle[ROTENCODER_NUM_INTERRUPTS];                                               // Pointer to instance per interrupt vector, nullptr if unused
+
+  template <class T, uint8_t N> static void isr() {                                                     // Trampoline for interrupt vector N
+    T* h = static_cast<T*>(intHandle[N]);                                                               //   Read handle once
+    if (h != nullptr) h->intr();                                                                        //   Call intr() in instance type T directly
+  }
+  template <class T, uint8_t N = 0> struct Vector {                                                     // Selects trampoline at begin(), never in interrupts
+    static IsrT get(uint8_t n) { return (n == N) ? &isr<T, N> : Vector<T, N + 1>::get(n); }
+  };
+  template <class T> struct Vector<T, ROTENCODER_NUM_INTERRUPTS> {                                      // End of table, no trampoline
+    static IsrT get(uint8_t) { return nullptr; }
+  };
+
+  template <class T, uint8_t N> static void wake() {                                                    // Trampoline for wake on LOW level, first interrupt after sleep
+    attachInterrupt(N, &isr<T, N>, CHANGE);                                                             //   Back to CHANGE, a LOW level interrupt repeats while the pin is low
+    RotEncoderWake::notify();                                                                           //   Main loop wakes, also if no step is counted
+    isr<T, N>();
+  }
+  template <class T, uint8_t N = 0> struct WakeVector {                                                 // Selects wake trampoline in prepareSleep(), only instantiated if used
+    static IsrT get(uint8_t n) { return (n == N) ? &wake<T, N> : WakeVector<T, N + 1>::get(n); }
+  };
+  template <class T> struct WakeVector<T, ROTENCODER_NUM_INTERRUPTS> {
+    static IsrT get(uint8_t) { return nullptr; }
+  };
+};
+
+
+// Devirtualized encoder core using CRTP (Curiously Recurring Template Pattern):
+//
+//   RotEncoderT<Derived> contains the decoder, position and interrupt handling. All pin and I/O functions are called through
+//   Derived, and can be overridden by declaring a function with the same name in Derived (no virtual keyword). The functions
+//   are resolved at compile time and inlined into intr(), there is no vtable and no indirect calls in the interrupt path.
+//   If the I/O functions are declared protected in Derived, Derived must have `friend class RotEncoderT<Derived>;`.
+//
+//   class MyEncoder : public RotEncoderT<MyEncoder> {
+//   public:
+//     uint8_t getPinA() const { return 5; }                                                          // Use pin 5 and 6
+//     uint8_t getPinB() const { return 6; }
+//   };
+//
+//   The Decoder template parameter selects the state machine, see RotEncoderDecoder.h, and the Counter template parameter
+//   selects the counter type and overflow policy of the position, see RotEncoderCounter.h.
+//
+//   Hooks are overridden the same way. onStep(dir) is called from intr() after each counted step, with dir = +1 or -1, and
+//   increment(dir) returns the value added to position for the step. The default hooks are removed by the compiler.
+//
+//   With ROTENCODER_STATS defined, getStats() returns statistics of intr(), see RotEncoderStats.h. RotEncoder has none.
+//
+//   intr() does not change the interrupt state. It is called from the interrupt vector, which runs with interrupts disabled
+//   on AVR, so no other interrupt can come between the read of the pins and the update of position. On 32-bit targets the
+//   vectors of PinA and PinB have the same priority and do not preempt each other. Turning interrupts on at the end of
+//   intr(), before the vector returns, would allow a nested interrupt to stack all registers once more.
+
+class RotEncoder;
+template <class Derived> struct RotEncoderStatsFor { typedef RotEncoderStats type; };                   // Statistics base of the core, see RotEncoderStats.h
+template <> struct RotEncoderStatsFor<RotEncoder> { typedef RotEncoderNoStats type; };                  // Core compiled in RotEncoder.cpp, same layout in all files
+
+template <class Derived, class Decoder = RotEncoderStdDecoder, class Counter = RotEncoderCounter>
+class RotEncoderT : public RotEncoderStatsFor<Derived>::type {                                          // CRTP core for RotEncoder, statistics take no memory if disabled
+  typedef typename RotEncoderStatsFor<Derived>::type StatsT;
+public:                                                                                                 // Default pin numbers, can be overridden in Derived
+  inline uint8_t getPinA() const __attribute__((always_inline)) { return 2; }                           // Setup default pin number to pin 2 for PinA
+  inline uint8_t getPinB() const __attribute__((always_inline)) { return 3; }                           // Setup default pin number to pin 3 for PinB
+
+protected:
+  void intr();                                                                                          // Interrupt handler function, called if PinA or PinB changes
+
+// Input/output functions that can be overridden in Derived e.g. to use faster or other I/O routines
+  inline bool rdPinA() __attribute__((always_inline)) { return !digitalRead(self().getPinA()); }        // Reads pinA (high when switch closed, low open)
+  inline bool rdPinB() __attribute__((always_inline)) { return !digitalRead(self().getPinB()); }        // Reads pinB (high when switch closed, low open)
+  inline uint8_t rdPins() __attribute__((always_inline)) { return (self().rdPinA() ? Decoder::PinA : 0) | (self().rdPinB() ? Decoder::PinB : 0); } // Reads both pins, bit 1 = PinA, bit 0 = PinB
+  inline void enPinA() __attribute__((always_inline)) { pinMode(self().getPinA(), INPUT_PULLUP); }      // Set to input and activate pull-up for pinA
+  inline void enPinB() __attribute__((always_inline)) { pinMode(self().getPinB(), INPUT_PULLUP); }      // Set to input and activate pull-up for pinB
+
+// These functions are used to disable inputs, to lower static current:                                 // Disable input: Sets pullup inactive and sets pin to output low
+  inline void diPinA() __attribute__((always_inline)) { digitalWrite(self().getPinA(), LOW); pinMode(self().getPinA(), OUTPUT); } // Input disable for PinA
+  inline void diPinB() __attribute__((always_inline)) { digitalWrite(self().getPinB(), LOW); pinMode(self().getPinB(), OUTPUT); } // Input disable for PinB
+
+// Hooks called from intr(), can be overridden in Derived
+  inline int8_t increment(int8_t dir) __attribute__((always_inline)) { return dir; }                    // Returns value added to position for a step, dir = +1 or -1
+  inline void onStep(int8_t) __attribute__((always_inline)) { }                                         // Called after each counted step, dir = +1 or -1
+
+public:
+  typedef typename Counter::ValueT PositionT;                                                           // Type of position, long by default
+  PositionT getPosition() const;                                                                        // Returns rotary encoder position
+  void setPosition(PositionT pos) { counter.set(pos); }                                                 // Set position
+  void reset() { counter.set(0); }                                                                      // Set position to 0
+  PositionT readAndResetDelta() { return counter.exchange(); }                                          // Returns steps since last call, and sets position to 0 or range end
+  PositionT getDistance(PositionT from, PositionT to) const { return counter.distance(from, to); }      // Steps between two positions, shorter way round a wrapping range
+  bool prepareSleep();                                                                                  // Set wake sources for deep sleep, returns false if the encoder can not wake the MCU now
+  void resumeFromSleep();                                                                               // Restore interrupts after sleep
+  template <class C = Counter> void setRange(PositionT min, PositionT max, bool wrap = false) { counter.setRange(min, max, wrap); } // Limit position in intr(), RotEncoderRangeCounter only
+  template <class D = Decoder> uint16_t getErrors() const { return decoder.getErrors(); }               // Returns number of lost steps detected, RotEncoderQuadDecoder only
+  template <class D = Decoder> void resetErrors() { decoder.resetErrors(); }                            // Clears number of lost steps
+  bool begin();                                                                                         // Start rotary encoder, returns true if successful
+  bool end();                                                                                           // Stop rotary encoder, returns true if successful
+  bool isStarted() const { return intA != NOT_AN_INTERRUPT; }                                           // True between begin() and end()
+  ~RotEncoderT() { end(); }                                                                             // Destructor should call end() to safely detach interrupts
+
+private:
+  friend class RotEncoderISR;                                                                           // Trampolines calls intr()
+  inline Derived& self() __attribute__((always_inline)) { return *static_cast<Derived*>(this); }        // This as Derived, resolved at compile time
+  inline const Derived& self() const __attribute__((always_inline)) { return *static_cast<const Derived*>(this); }
+  Counter counter;                                                                                      // Position, updated in interrupts
+  Decoder decoder;                                                                                      // State machine for the rotary switch
+  int8_t claim(uint8_t pin);                                                                            // Claims interrupt for pin, returns interrupt number
+  void release(int8_t intNum);                                                                          // Releases interrupt claimed by claim()
+  int8_t intA = NOT_AN_INTERRUPT;                                                                       // Interrupt number claimed for PinA, or ROTENCODER_PIN_CHANGE, stored to not depend on Derived in end()
+  int8_t intB = NOT_AN_INTERRUPT;                                                                       // Interrupt number claimed for PinB
+};
+
+
+class RotEncoder : public RotEncoderT<RotEncoder> {                                                     // Interface for RotEncoder
 public:                                                                                                 // Default pin numbers, can be overridden
   inline virtual uint8_t getPinA() const __attribute__((always_inline)) { return 2;                   } // Setup default pin number to pin 2 for PinA
   inline virtual uint8_t getPinB() const __attribute__((always_inline)) { return 3;                   } // Setup default pin number to pin 3 for PinB
 
 protected:
-  void intr();                                                                                          // Interrupt handler function, called if PinA or PinB changes
+  friend class RotEncoderT<RotEncoder>;                                                                 // Core calls the virtual I/O functions below
 
 // Input/output functions that can be overloaded e.g. to use faster or other I/O routines
   inline virtual bool rdPinA() __attribute__((always_inline))   { return !digitalRead(getPinA());     } // Reads pinA (high when switch closed, low open)
   inline virtual bool rdPinB() __attribute__((always_inline))   { return !digitalRead(getPinB());     } // Reads pinB (high when switch closed, low open)
+  inline virtual uint8_t rdPins() { return (rdPinA() ? RotEncoderDecoder::PinA : 0) | (rdPinB() ? RotEncoderDecoder::PinB : 0); } // Reads both pins, bit 1 = PinA, bit 0 = PinB
   inline virtual void enPinA() __attribute__((always_inline))   { pinMode(getPinA(), INPUT_PULLUP);   } // Set to input and activate pull-up for pinA
   inline virtual void enPinB() __attribute__((always_inline))   { pinMode(getPinB(), INPUT_PULLUP);   } // Set to input and activate pull-up for pinB
 
@@ -63,27 +226,248 @@ protected:
   inline virtual void diPinB() __attribute__((always_inline))   { digitalWrite(getPinB(), LOW); pinMode(getPinB(), OUTPUT); } // Input disable for PinB
 
 public:
-  long getPosition() const;                                                                             // Returns rotary encoder position
-  bool begin();                                                                                         // Start rotary encoder, returns true if successful
-  bool end();                                                                                           // Stop rotary encoder, returns true if successful
   virtual ~RotEncoder() { end(); }                                                                      // Destructor should call end() to safely detach interrupts
-
-private:
-  volatile long position = 0;                                                                           // Position, volatile, updated in interrupts
-  bool cntflg = false;                                                                                  // Set true to count up, default is not count
-  bool lrflg;                                                                                           // Left or right side last
-  bool inA, inB;                                                                                        // Stores inA, inB (to not use of local variables in interrupt)
-  typedef RotEncoder* volatile IntHandleT;                                                              // Pointer to this class for interrupts
-  static IntHandleT intHandle;                                                                          // Pointer to interrupt handle = this when active
-  static void isr() { if (intHandle!=NULL) intHandle->intr(); }                                         // Interrupt service routine executes intr() function in this class
 };
 
+extern template class RotEncoderT<RotEncoder>;                                                          // Instantiated once in RotEncoder.cpp
+
 
 template <uint8_t PinA, uint8_t PinB>                                                                   // Template to use other pins than standard pin <2,3>
 class RotEncoderPins : public RotEncoder {
 public:                                                                                                 // Overridden functions to setup PinA and PinB based on template parameters
   inline uint8_t getPinA() const override __attribute__((always_inline)) { return PinA; }               // Setup getPinA() to return with PinA from template
   inline uint8_t getPinB() const override __attribute__((always_inline)) { return PinB; }               // Setup getPinB() to return with PinB from template
+
+#ifdef ROTENCODER_DIRECT_IO                                                                             // Pins known at compile time, use direct port I/O
+protected:
+  inline bool rdPinA() override __attribute__((always_inline)) { return RotEncoderPortIO<PinA>::rd(); } // Reads pinA by single port read
+  inline bool rdPinB() override __attribute__((always_inline)) { return RotEncoderPortIO<PinB>::rd(); } // Reads pinB by single port read
+  inline void enPinA() override __attribute__((always_inline)) { RotEncoderPortIO<PinA>::en(); }        // Input with pull-up for pinA
+  inline void enPinB() override __attribute__((always_inline)) { RotEncoderPortIO<PinB>::en(); }        // Input with pull-up for pinB
+  inline void diPinA() override __attribute__((always_inline)) { RotEncoderPortIO<PinA>::di(); }        // Input disable for PinA
+  inline void diPinB() override __attribute__((always_inline)) { RotEncoderPortIO<PinB>::di(); }        // Input disable for PinB
+#endif
+};
+
+
+template <class Derived, class Self> struct RotEncoderDerived { typedef Derived type; };                // Derived type for CRTP, Self if Derived is void
+template <class Self> struct RotEncoderDerived<void, Self> { typedef Self type; };
+
+// Devirtualized RotEncoderPins, no vtable. Set Derived to your own class to override hooks or I/O functions:
+//
+//   class Knob : public RotEncoderPinsT<2, 3, RotEncoderStdDecoder, Knob> { ... };
+//
+//   With ROTENCODER_DIRECT_IO, rdPins() reads both pins in one port read, without rdPinA() and rdPinB(). A Derived class
+//   that overrides rdPinA() or rdPinB() must override rdPins() too. RotEncoderPins keeps rdPins() from RotEncoder, which
+//   calls the virtual rdPinA() and rdPinB().
+
+template <uint8_t PinA, uint8_t PinB, class Decoder = RotEncoderStdDecoder, class Derived = void, class Counter = RotEncoderCounter>
+class RotEncoderPinsT : public RotEncoderT<typename RotEncoderDerived<Derived, RotEncoderPinsT<PinA, PinB, Decoder, Derived, Counter> >::type, Decoder, Counter> {
+  typedef RotEncoderT<typename RotEncoderDerived<Derived, RotEncoderPinsT>::type, Decoder, Counter> Core;        // CRTP core
+public:
+  inline uint8_t getPinA() const __attribute__((always_inline)) { return PinA; }                        // Setup getPinA() to return with PinA from template
+  inline uint8_t getPinB() const __attribute__((always_inline)) { return PinB; }                        // Setup getPinB() to return with PinB from template
+
+#ifdef ROTENCODER_DIRECT_IO                                                                             // Pins known at compile time, use direct port I/O
+protected:
+  friend Core;                                                                                          // Core calls the I/O functions below
+  inline bool rdPinA() __attribute__((always_inline)) { return RotEncoderPortIO<PinA>::rd(); }          // Reads pinA by single port read
+  inline bool rdPinB() __attribute__((always_inline)) { return RotEncoderPortIO<PinB>::rd(); }          // Reads pinB by single port read
+  inline uint8_t rdPins() __attribute__((always_inline)) { return RotEncoderPortPair<PinA, PinB>::rd(); } // Reads both pins, one port read if same port
+  inline void enPinA() __attribute__((always_inline)) { RotEncoderPortIO<PinA>::en(); }                 // Input with pull-up for pinA
+  inline void enPinB() __attribute__((always_inline)) { RotEncoderPortIO<PinB>::en(); }                 // Input with pull-up for pinB
+  inline void diPinA() __attribute__((always_inline)) { RotEncoderPortIO<PinA>::di(); }                 // Input disable for PinA
+  inline void diPinB() __attribute__((always_inline)) { RotEncoderPortIO<PinB>::di(); }                 // Input disable for PinB
+#endif
 };
 
+
+// Pins set at run time, e.g. one binary for board variants with different wiring:
+//
+//   RotEncoderRuntimePins<> knob;
+//   knob.begin(rev2 ? 4 : 2, rev2 ? 5 : 3);                                                        // Pins of this board
+//
+//   begin(pinA, pinB) resolves the input, direction and output registers and the bitmasks of the pins once. On AVR the
+//   interrupt handler then reads and writes the registers through the cached pointers, without the pin table lookups of
+//   digitalRead() and pinMode(), and both pins are read in one read if they are on the same port. The interrupt numbers
+//   are resolved once by begin() as for all encoders. Other targets use the Arduino functions with the pins of begin().
+
+template <class Decoder = RotEncoderStdDecoder, class Derived = void, class Counter = RotEncoderCounter>
+class RotEncoderRuntimePins : public RotEncoderT<typename RotEncoderDerived<Derived, RotEncoderRuntimePins<Decoder, Derived, Counter> >::type, Decoder, Counter> {
+  typedef RotEncoderT<typename RotEncoderDerived<Derived, RotEncoderRuntimePins>::type, Decoder, Counter> Core; // CRTP core
+public:
+  inline uint8_t getPinA() const __attribute__((always_inline)) { return pinA; }                        // Returns PinA set by begin()
+  inline uint8_t getPinB() const __attribute__((always_inline)) { return pinB; }                        // Returns PinB set by begin()
+  bool begin(uint8_t a, uint8_t b);                                                                     // Start rotary encoder on pins a and b, returns true if successful
+
+#if defined(__AVR__) && !defined(__AVR_XMEGA__)                                                         // Classic AVR: Pull-up is the output register of an input
+protected:
+  friend Core;                                                                                          // Core calls the I/O functions below
+  inline bool rdPinA() __attribute__((always_inline)) { return !(*inA & maskA); }                       // Reads pinA through cached register
+  inline bool rdPinB() __attribute__((always_inline)) { return !(*inB & maskB); }                       // Reads pinB through cached register
+  inline uint8_t rdPins() __attribute__((always_inline)) {                                              // Reads both pins, one read if same port
+    if (inA == inB) {
+      uint8_t v = *inA;
+      return ((v & maskA) ? 0 : Decoder::PinA) | ((v & maskB) ? 0 : Decoder::PinB);
+    }
+    return (rdPinA() ? Decoder::PinA : 0) | (rdPinB() ? Decoder::PinB : 0);
+  }
+  inline void enPinA() __attribute__((always_inline)) { *modeA &= ~maskA; *outA |= maskA; }             // Input with pull-up for pinA
+  inline void enPinB() __attribute__((always_inline)) { *modeB &= ~maskB; *outB |= maskB; }             // Input with pull-up for pinB
+  inline void diPinA() __attribute__((always_inline)) { *outA &= ~maskA; *modeA |= maskA; }             // Input disable for PinA
+  inline void diPinB() __attribute__((always_inline)) { *outB &= ~maskB; *modeB |= maskB; }             // Input disable for PinB
+
+private:
+  volatile uint8_t* inA = nullptr;                                                                      // Registers of PinA, resolved by begin()
+  volatile uint8_t* modeA = nullptr;
+  volatile uint8_t* outA = nullptr;
+  volatile uint8_t* inB = nullptr;                                                                      // Registers of PinB
+  volatile uint8_t* modeB = nullptr;
+  volatile uint8_t* outB = nullptr;
+  uint8_t maskA = 0, maskB = 0;                                                                         // Bitmasks of pins in registers
+#endif
+
+private:
+  uint8_t pinA = 2;                                                                                     // Pins set by begin(), default pin 2 and 3
+  uint8_t pinB = 3;
+};
+
+template <class Decoder, class Derived, class Counter>
+bool RotEncoderRuntimePins<Decoder, Derived, Counter>::begin(uint8_t a, uint8_t b) {                    // Start rotary encoder on pins a and b
+  if (this->isStarted()) return false;                                                                  // Already started, pins are used by intr()
+  if ((digitalPinToPort(a) == NOT_A_PIN) || (digitalPinToPort(b) == NOT_A_PIN)) return false;           // Not digital pins
+  pinA = a; pinB = b;
+#if defined(__AVR__) && !defined(__AVR_XMEGA__)
+  maskA = digitalPinToBitMask(a);                                                                       // Resolve registers and bitmasks once
+  maskB = digitalPinToBitMask(b);
+  inA = portInputRegister(digitalPinToPort(a));
+  inB = portInputRegister(digitalPinToPort(b));
+  modeA = portModeRegister(digitalPinToPort(a));
+  modeB = portModeRegister(digitalPinToPort(b));
+  outA = portOutputRegister(digitalPinToPort(a));
+  outB = portOutputRegister(digitalPinToPort(b));
+  bool ok;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { ok = Core::begin(); }                                             // Pull-ups are set by read-modify-write, an encoder on the same port may change it
+  return ok;
+#else
+  return Core::begin();
+#endif
+}
+
+// Implementation of RotEncoderT, in header because it is a template:
+
+template <class Derived, class Decoder, class Counter>
+bool RotEncoderT<Derived, Decoder, Counter>::begin() {                                                  // Start rotary encoder, returns true if successful
+  // Method to begin interrupt handling by claiming an interrupt for each pin and attaching its trampoline
+  if (intA != NOT_AN_INTERRUPT) return false;                                                           // Already started
+  self().enPinA();                                                                                      // Enable PinA and PinB inputs with pull-up
+  self().enPinB();
+  decoder.init(self().rdPins());                                                                        // Decoder starts from actual pins before claim() may enable a pin change mask
+  int8_t a = claim(self().getPinA());                                                                   // Interrupts for PinA and PinB
+  if (a == NOT_AN_INTERRUPT) return false;                                                              // Return false if pin has no interrupt or vector is used
+  int8_t b = claim(self().getPinB());
+  if (b == NOT_AN_INTERRUPT) {                                                                          // Both interrupts must be claimed, or none
+    release(a);
+    return false;
+  }
+  intA = a; intB = b;
+  if (a >= 0) attachInterrupt(a, RotEncoderISR::vector<Derived>(a), CHANGE);                            // Attach trampoline for PinA, set to change pin
+  if (b >= 0) attachInterrupt(b, RotEncoderISR::vector<Derived>(b), CHANGE);                            // Attach trampoline for PinB, set to change pin
+  return true;                                                                                          // Return true if ok
+}
+
+template <class Derived, class Decoder, class Counter>
+bool RotEncoderT<Derived, Decoder, Counter>::end() {                                                    // Stops interrupt handling, returns true if successful
+  // Method to stop interrupt handling by releasing the dispatch table slots and detaching the trampolines
+  if (intA == NOT_AN_INTERRUPT) return false;                                                           // Return false if not started
+  release(intA);                                                                                        // Remove handles to this class before detach
+  release(intB);
+  if (intA >= 0) detachInterrupt(intA);                                                                 // Detach interrupt for PinA
+  if (intB >= 0) detachInterrupt(intB);                                                                 // Detach interrupt for PinB
+  intA = intB = NOT_AN_INTERRUPT;
+  return true;                                                                                          // Return true if ok
+}
+
+template <class Derived, class Decoder, class Counter>
+bool RotEncoderT<Derived, Decoder, Counter>::prepareSleep() {                                           // Set wake sources for SLEEP_MODE_PWR_DOWN
+  // In power-down the external interrupts only wake on LOW level, pin change interrupts wake on any change. An open pin has
+  // its pull-up on, and a LOW level interrupt on it wakes when the switch closes. A closed pin is either low from its own
+  // switch, or driven low with the pull-up off, and can not wake on LOW. The next move of a closed pin is to open, which
+  // can not be seen by a level interrupt, so both pins closed can not wake the MCU.
+  if (intA == NOT_AN_INTERRUPT) return false;                                                           // Not started
+  uint8_t pins = self().rdPins();                                                                       // Closed pins, pull-ups on or off
+  if (((pins & (Decoder::PinA | Decoder::PinB)) == (Decoder::PinA | Decoder::PinB)) &&                  // Both closed: Can only wake on pin change interrupts
+      ((intA != ROTENCODER_PIN_CHANGE) || (intB != ROTENCODER_PIN_CHANGE))) return false;
+  if ((intA >= 0) && !(pins & Decoder::PinA)) attachInterrupt(intA, RotEncoderISR::wakeVector<Derived>(intA), LOW); // Open pin wakes when it closes
+  if ((intB >= 0) && !(pins & Decoder::PinB)) attachInterrupt(intB, RotEncoderISR::wakeVector<Derived>(intB), LOW);
+  return true;                                                                                          // A step between this and sleep wakes at once, see RotEncoderWake::sleep()
+}
+
+template <class Derived, class Decoder, class Counter>
+void RotEncoderT<Derived, Decoder, Counter>::resumeFromSleep() {                                        // Restore interrupts after sleep
+  if (intA >= 0) attachInterrupt(intA, RotEncoderISR::vector<Derived>(intA), CHANGE);                   // The pin that did not wake may still be LOW level
+  if (intB >= 0) attachInterrupt(intB, RotEncoderISR::vector<Derived>(intB), CHANGE);
+}
+
+template <class Derived, class Decoder, class Counter>
+int8_t RotEncoderT<Derived, Decoder, Counter>::claim(uint8_t pin) {                                     // Claims interrupt for pin, external interrupt first
+  int8_t i = digitalPinToInterrupt(pin);
+  if (RotEncoderISR::claim(i, &self())) return i;                                                       // External interrupt, slot in dispatch table
+#ifdef ROTENCODER_PCINT
+  if ((i == NOT_AN_INTERRUPT) && RotEncoderPcint::attach(pin, &self(), &RotEncoderISR::call<Derived>)) { // No external interrupt, pin change interrupt if enabled
+    return ROTENCODER_PIN_CHANGE;
+  }
+#endif
+  return NOT_AN_INTERRUPT;                                                                              // No interrupt, or vector used by other instance
+}
+
+template <class Derived, class Decoder, class Counter>
+void RotEncoderT<Derived, Decoder, Counter>::release(int8_t intNum) {                                   // Releases interrupt claimed by claim()
+#ifdef ROTENCODER_PCINT
+  if (intNum == ROTENCODER_PIN_CHANGE) { RotEncoderPcint::detach(&self()); return; }                    // Detaches all pin change pins of this instance
+#endif
+  RotEncoderISR::release(intNum, &self());
+}
+
+template <class Derived, class Decoder, class Counter>
+typename Counter::ValueT RotEncoderT<Derived, Decoder, Counter>::getPosition() const {                  // Returns actual value from the rotary encoder
+  return counter.get();                                                                                 // Lock-free read, see RotEncoderCounter.h
+}
+
+template <class Derived, class Decoder, class Counter>
+void RotEncoderT<Derived, Decoder, Counter>::intr() {                                                   // Immplementation of interrupt handler for rotary encoder
+  Derived& d = self();                                                                                  // All I/O resolved at compile time through Derived
+  typename StatsT::CyclesT start = this->statsStart();                                                  // Start time, only with ROTENCODER_STATS
+  d.enPinA(); d.enPinB();                                                                               // Uses built-in pull-ups
+  uint8_t pins;
+  if (Decoder::stableRead) {                                                                            // Resolved at compile time
+    while (true) {                                                                                      // Read inputs, ensure stable valid readings
+      pins = d.rdPins();                                                                                //   Read inputs
+      if (pins == d.rdPins()) break;                                                                    // Stop when stable
+      this->statsRetry();                                                                               //   Count retry
+    }
+  } else {
+    pins = d.rdPins();                                                                                  // Single read, bounded time
+  }
+
+  uint8_t r = decoder.next(pins);                                                                       // Run state machine
+  if (r & RotEncoderDecoder::DiA) d.diPinA();                                                           // Turn off pull-up current for closed switch
+  if (r & RotEncoderDecoder::DiB) d.diPinB();
+  if (r & (RotEncoderDecoder::Up | RotEncoderDecoder::Dn)) {                                            // Counted step:
+    int8_t dir = (r & RotEncoderDecoder::Up) ? 1 : -1;
+    counter.add(d.increment(dir));                                                                      //   Count position, increment is dir by default
+    d.onStep(dir);                                                                                      //   Hook, empty by default
+    if (Decoder::inferSteps && (r & RotEncoderDecoder::Two)) {                                          //   Lost step inferred by decoder, resolved at compile time
+      counter.add(d.increment(dir));
+      d.onStep(dir);
+    }
+  } else if (r & (RotEncoderDecoder::DiA | RotEncoderDecoder::DiB)) {                                   // One-sided position without count (cntflg false)
+    this->statsIgnored();
+  }
+  this->statsEnd(start);
+}
+
+#include "RotEncoderButton.h"  // Push button, uses the interrupt dispatch table above
+#include "RotEncoderPolicy.h"  // Encoder configured by I/O, decoder, counter and power policies
+
 #endif  // ROTENCODER_H
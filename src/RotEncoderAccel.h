@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderAccel.h                                                                                                         //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERACCEL_H
+#define ROTENCODERACCEL_H
+
+#include <Arduino.h>
+#include "RotEncoderClock.h"
+
+// Speed dependent acceleration of position increments:
+//
+//   RotEncoderAccel<BucketUs, Mult...> maps the interval since the previous step to a step multiplier. The interval is
+//   divided into buckets of BucketUs microseconds, and bucket i uses multiplier Mult[i], 1 to 127. Intervals beyond the last
+//   bucket use the last multiplier. The multipliers are stored in a table in flash generated at compile time. The bucket
+//   width is rounded to the nearest power of 2 timer ticks so the bucket is found by a shift, e.g. 4000 us is 4096 us on AVR
+//   at 16 MHz.
+//
+//   The cost in the interrupt handler is constant: a timer read, a subtraction, a shift, a compare and a table lookup.
+//   There is no floating point and no division.
+//
+//   class Knob : public RotEncoderPinsT<2, 3, RotEncoderStdDecoder, Knob> {
+//   public:
+//     RotEncoderAccel<4000, 10, 5, 2, 1> accel;                                                      // < 4 ms: x10, < 8 ms: x5, < 12 ms: x2, else x1
+//     int8_t increment(int8_t dir) { return accel.increment(dir); }                                  // Hook called by intr()
+//   };
+
+struct RotEncoderAccelMult {                                                                            // Compile time check of multipliers
+  static constexpr bool valid() { return true; }                                                        // True if all multipliers are 1 to 127, increment() is int8_t
+  template <class... T> static constexpr bool valid(uint8_t m, T... ms) { return (m >= 1) && (m <= 127) && valid(ms...); }
+};
+
+template <uint16_t BucketUs, uint8_t... Mult>
+class RotEncoderAccel {                                                                                 // Acceleration table, interval buckets to multipliers
+  static constexpr uint8_t size = sizeof...(Mult);                                                      // Number of buckets
+  static_assert((size >= 1) && (size <= 128), "RotEncoderAccel: 1 to 128 multipliers");
+  static_assert(RotEncoderAccelMult::valid(Mult...), "RotEncoderAccel: Each multiplier must be 1 to 127");
+
+  static constexpr uint8_t log2(uint32_t v) { return (v <= 1) ? 0 : 1 + log2(v >> 1); }                 // Floor of log2, at compile time
+  static constexpr uint32_t ticks = (uint32_t)BucketUs * (RotEncoderClock::ticksPerSecond / 1000) / 1000; // Bucket width in ticks
+  static constexpr uint8_t shift = log2(ticks + ticks / 2);                                             // Bucket width as shift, rounded to nearest power of 2
+
+public:
+  inline int8_t increment(int8_t dir) __attribute__((always_inline)) {                                  // Interrupt handler: Returns dir times multiplier
+    uint32_t t = RotEncoderClock::now32();                                                              // Timer read
+    uint32_t b = (t - last) >> shift;                                                                   // Interval bucket
+    last = t;
+    uint8_t m = pgm_read_byte(&table[(b < size - 1) ? b : (size - 1)]);                                 // Multiplier from flash, last bucket for long intervals
+    return (dir > 0) ? m : -m;
+  }
+
+private:
+  static const uint8_t table[size];                                                                     // Multipliers in flash
+  uint32_t last = 0;                                                                                    // Timestamp of previous step
+};
+
+template <uint16_t BucketUs, uint8_t... Mult>
+const uint8_t RotEncoderAccel<BucketUs, Mult...>::table[RotEncoderAccel<BucketUs, Mult...>::size] PROGMEM = { Mult... };         // Generated at compile time
+
+#endif  // ROTENCODERACCEL_H
@@ -0,0 +1,66 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderAtomic.h                                                                                                        //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERATOMIC_H
+#define ROTENCODERATOMIC_H
+
+#include <Arduino.h>
+
+// Atomic blocks on all architectures:
+//
+//   On AVR util/atomic.h is used. Many 32-bit cores have no util/atomic.h, so a minimal ATOMIC_BLOCK() is defined here
+//   if the core does not have one. On ARM the interrupt state (PRIMASK) is restored at the end of the block, on other
+//   cores interrupts are enabled at the end of the block, as with ATOMIC_FORCEON.
+
+#if defined(__AVR__)
+  #include <util/atomic.h>                                                                              // Required for 8/16-bit systems to ensure atomic operations
+#elif !defined(ATOMIC_BLOCK)
+
+class RotEncoderAtomicGuard {                                                                           // Disables interrupts while in scope
+public:
+#if defined(__arm__)
+  RotEncoderAtomicGuard() : primask(__get_PRIMASK()) { __disable_irq(); }                               // Save interrupt state and disable
+  ~RotEncoderAtomicGuard() { __set_PRIMASK(primask); }                                                  // Restore interrupt state
+#else
+  RotEncoderAtomicGuard() { noInterrupts(); }
+  ~RotEncoderAtomicGuard() { interrupts(); }
+#endif
+  bool once() { bool r = first; first = false; return r; }                                              // True first time only, runs block once
+
+private:
+#if defined(__arm__)
+  uint32_t primask;
+#endif
+  bool first = true;
+};
+
+  #define ATOMIC_RESTORESTATE 0
+  #define ATOMIC_FORCEON 0
+  #define ATOMIC_BLOCK(type) for (RotEncoderAtomicGuard _atomicGuard; _atomicGuard.once(); )            // Same use as util/atomic.h
+#endif
+
+#endif  // ROTENCODERATOMIC_H
@@ -0,0 +1,170 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderBank.h                                                                                                          //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERBANK_H
+#define ROTENCODERBANK_H
+
+#include <Arduino.h>
+#include "RotEncoderAtomic.h"
+#include "RotEncoderIO.h"
+#include "RotEncoderPcint.h"
+
+// Bank of encoders on one port, decoded together (AVR with direct port I/O):
+//
+//   RotEncoderBank<Port, Masks...> decodes all encoders on a port from one port read in one pin change interrupt. Each
+//   mask selects the two adjacent pins of one encoder in the port, the higher bit is PinA. The state machine of
+//   RotEncoderStdDecoder runs on all encoders at once: Bit n of each state byte belongs to the encoder with PinB at bit n
+//   (SWAR, SIMD within a register), so the decoding has no loop over the encoders, and the pull-ups of all closed switches
+//   are turned off with one write. The positions are in one array with one sequence counter, and getPositions() copies
+//   all of them from the same instant.
+//
+//   RotEncoderBank<RotEncoderPortD, 0x0C, 0x30, 0xC0> mixer;                                       // D2/D3, D4/D5, D6/D7
+//
+//   begin() enables pin change interrupts (RotEncoderPcint::enable()) and attaches all pins of the bank.
+
+#if defined(ROTENCODER_DIRECT_IO) && defined(ROTENCODER_PCINT) && defined(PCICR)                      // ATmega328P family, ports of RotEncoderPort
+
+struct RotEncoderBankMask {                                                                             // Compile time checks of bank masks
+  static constexpr uint8_t lane(uint8_t m) { return m & ~(m << 1); }                                    // PinB bit of mask
+  static constexpr uint8_t lanes() { return 0; }                                                        // PinB bits of all masks
+  template <class... T> static constexpr uint8_t lanes(uint8_t m, T... ms) { return lane(m) | lanes(ms...); }
+  static constexpr uint8_t port(uint8_t p) { return (p == RotEncoderPortD) ? 0xFF : 0x3F; }             // Pins of port with an Arduino pin number, PB6/PB7 and PC6 have none
+  static constexpr bool valid() { return true; }                                                        // True if all masks are two adjacent pins, not overlapping
+  template <class... T> static constexpr bool valid(uint8_t m, T... ms) { return (m == lane(m) * 3) && ((m & (lanes(ms...) * 3)) == 0) && valid(ms...); }
+};
+
+template <uint8_t Port, uint8_t... Masks>
+class RotEncoderBank {                                                                                  // Encoders on one port
+public:
+  static constexpr uint8_t size = sizeof...(Masks);                                                     // Number of encoders
+  static_assert((size > 0) && RotEncoderBankMask::valid(Masks...), "RotEncoderBank: Each mask must be two adjacent pins, not used by other masks");
+  static_assert((Port == RotEncoderPortD) || (Port == RotEncoderPortB) || (Port == RotEncoderPortC), "RotEncoderBank: Port must be a RotEncoderPort");
+  static_assert(((RotEncoderBankMask::lanes(Masks...) * 3) & ~RotEncoderBankMask::port(Port)) == 0, "RotEncoderBank: Masks use bits 6 or 7 of PORTB or PORTC");
+
+  long getPosition(uint8_t i) const {                                                                   // Returns position of encoder i, lock-free
+    long pos;
+    uint8_t s;
+    do {
+      s = seq;
+      pos = position[i];
+    } while (s != seq);                                                                                 // Retry if an interrupt changed a position during read
+    return pos;
+  }
+
+  void getPositions(long* out) const {                                                                  // Copies all positions, from the same instant
+    uint8_t s;
+    do {
+      s = seq;                                                                                          // Read sequence counter
+      for (uint8_t i = 0; i < size; i++) out[i] = position[i];
+    } while (s != seq);                                                                                 // Retry if an interrupt changed a position during copy
+  }
+
+  bool begin();                                                                                         // Start all encoders, returns true if successful
+  bool end();                                                                                           // Stop all encoders, returns true if successful
+  ~RotEncoderBank() { end(); }                                                                          // Destructor should call end() to safely detach interrupts
+
+private:
+  static void call(void* handle) { static_cast<RotEncoderBank*>(handle)->intr(); }                      // Called by pin change vector
+  typedef RotEncoderPortIO<Port> IO;                                                                    // Registers of port
+  static constexpr uint8_t laneB = RotEncoderBankMask::lanes(Masks...);                                 // PinB bits of all encoders
+  static constexpr uint8_t pins = laneB * 3;                                                            // All pins of the bank
+  static constexpr uint8_t masks[sizeof...(Masks)] = { Masks... };
+
+  void intr();                                                                                          // Interrupt handler, decodes all encoders
+
+  volatile long position[sizeof...(Masks)] = {};                                                        // Positions, updated in interrupts
+  volatile uint8_t seq = 0;                                                                             // Sequence counter, changed every time a position is changed
+  uint8_t cntflg = 0;                                                                                   // Count flags, one bit per encoder
+  uint8_t lrflg = 0;                                                                                    // Left or right side last, one bit per encoder
+  bool started = false;
+};
+
+template <uint8_t Port, uint8_t... Masks>
+constexpr uint8_t RotEncoderBank<Port, Masks...>::masks[sizeof...(Masks)];
+
+
+template <uint8_t Port, uint8_t... Masks>
+bool RotEncoderBank<Port, Masks...>::begin() {                                                          // Start all encoders, returns true if successful
+  if (started) return false;                                                                            // Already started
+  RotEncoderPcint::enable();                                                                            // Bank always uses the pin change vector of the port
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {                                                                   // Read-modify-write, an encoder on the same port may change it in its interrupt
+    _SFR_IO8(IO::ddrReg) &= ~pins;                                                                      // Inputs with pull-up
+    _SFR_IO8(IO::portReg) |= pins;
+  }
+  for (uint8_t b = 0; b < 8; b++) {
+    if (!(pins & (1 << b))) continue;
+    if (!RotEncoderPcint::attach(Port + b, this, &call)) {                                              // Pin is used by other instance
+      RotEncoderPcint::detach(this);
+      return false;
+    }
+  }
+  started = true;
+  return true;                                                                                          // Return true if ok
+}
+
+template <uint8_t Port, uint8_t... Masks>
+bool RotEncoderBank<Port, Masks...>::end() {                                                            // Stop all encoders, returns true if successful
+  if (!started) return false;                                                                           // Return false if not started
+  RotEncoderPcint::detach(this);
+  started = false;
+  return true;                                                                                          // Return true if ok
+}
+
+template <uint8_t Port, uint8_t... Masks>
+void RotEncoderBank<Port, Masks...>::intr() {                                                           // Interrupt handler, all encoders in one pass
+  _SFR_IO8(IO::ddrReg) &= ~pins;                                                                        // Uses built-in pull-ups
+  _SFR_IO8(IO::portReg) |= pins;
+  uint8_t v = ~_SFR_IO8(IO::pinReg);                                                                    // Single read of port, high when switch closed
+  uint8_t a = (v >> 1) & laneB;                                                                         // PinA of each encoder, moved to its PinB bit
+  uint8_t b = v & laneB;                                                                                // PinB of each encoder
+
+  // Same state machine as RotEncoderStdDecoder, for all encoders in parallel:
+  uint8_t ab = a & b;                                                                                   // InA on and InB on: Set count flag
+  uint8_t an = a & ~b;                                                                                  // InA on and InB off: Count up if oposite position, lrflg = 1
+  uint8_t bn = b & ~a;                                                                                  // InA off and InB on: Count dn if oposite position, lrflg = 0
+  uint8_t up = an & cntflg & ~lrflg;
+  uint8_t dn = bn & cntflg & lrflg;
+  cntflg = (cntflg | ab) & ~(an | bn);                                                                  // Clear count flag in one sided positions
+  lrflg = (lrflg | an) & ~bn;
+
+  uint8_t di = (an << 1) | bn;                                                                          // Turn off pull-up current for closed switches
+  _SFR_IO8(IO::portReg) &= ~di;
+  _SFR_IO8(IO::ddrReg) |= di;
+
+  if (up | dn) {                                                                                        // Count positions of encoders with a step
+    for (uint8_t i = 0; i < size; i++) {
+      uint8_t l = RotEncoderBankMask::lane(masks[i]);
+      if (up & l) position[i]++;
+      if (dn & l) position[i]--;
+    }
+    seq++;                                                                                              // Tell readers positions changed
+  }
+}
+
+#endif
+
+#endif  // ROTENCODERBANK_H
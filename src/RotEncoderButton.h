@@ -0,0 +1,196 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderButton.h                                                                                                        //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERBUTTON_H
+#define ROTENCODERBUTTON_H
+
+#include <Arduino.h>
+
+// Push button of the rotary encoder, debounced by timestamps in the interrupt handler (included by RotEncoder.h):
+//
+//   RotEncoderButton<Pin, Events> uses the same interrupt dispatch as the encoder (external or pin change interrupt), and
+//   pushes RotEncoderEvent::Click, DoubleClick and LongPress events into the event ring of the encoder. Nothing blocks:
+//
+//   - Debounce: The first edge after a stable period is taken at once, edges within the debounce time are ignored.
+//   - Dynamic pull-up: When a press is taken, the pull-up is turned off (output low), so a held button draws no current and
+//     contact bounce can not give more interrupts. update() turns the pull-up on again every release check period (default
+//     20 ms), and off again at the next update() if the button is still held.
+//   - Timeouts: A click is pushed when the double click time has passed without a second click, and a long press while the
+//     button is held. These are checked by update(), which must be called from the main loop.
+//
+//   The interrupt handler is the producer of the ring. update() pushes events with interrupts disabled, so it is never
+//   concurrent with the interrupt handler.
+//
+//   Knob knob;                                                                                       // Knob with RotEncoderEvents<16> events, see RotEncoderEvents.h
+//   RotEncoderButton<4, RotEncoderEvents<16> > button;
+//
+//   void setup() { knob.begin(); button.begin(knob.events); }
+//   void loop()  { button.update(); ... knob.events.drain(ev, 8) ... }
+
+template <uint8_t Pin, class Events>
+class RotEncoderButton {                                                                                // Push button with debounce and click events
+public:
+  bool begin(Events& e);                                                                                // Start button, events go to e, returns true if successful
+  bool end();                                                                                           // Stop button, returns true if successful
+  ~RotEncoderButton() { end(); }                                                                        // Destructor should call end() to safely detach interrupts
+  void update();                                                                                        // Main loop: Timeouts and release check, call often
+  bool isPressed() const { return down; }                                                               // Debounced state
+
+  void setTimes(uint16_t debounceMs, uint16_t doubleMs, uint16_t longMs, uint16_t checkMs = 20) {       // Set times in ms
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {                                                                 // Used by interrupt handler
+      debounce = ticks(debounceMs);
+      dbl = ticks(doubleMs);
+      lng = ticks(longMs);
+      check = ticks(checkMs);
+    }
+  }
+
+private:
+  friend class RotEncoderISR;                                                                           // Trampolines calls intr()
+  static uint32_t ticks(uint16_t ms) { return (uint32_t)ms * (RotEncoderClock::ticksPerSecond / 1000); } // ms to clock ticks
+
+#ifdef ROTENCODER_DIRECT_IO
+  static inline bool rd() __attribute__((always_inline)) { return RotEncoderPortIO<Pin>::rd(); }        // Reads pin (high when switch closed)
+  static inline void en() __attribute__((always_inline)) { RotEncoderPortIO<Pin>::en(); }               // Input with pull-up
+  static inline void di() __attribute__((always_inline)) { RotEncoderPortIO<Pin>::di(); }               // Output low, pull-up off
+#else
+  static inline bool rd() __attribute__((always_inline)) { return !digitalRead(Pin); }
+  static inline void en() __attribute__((always_inline)) { pinMode(Pin, INPUT_PULLUP); }
+  static inline void di() __attribute__((always_inline)) { digitalWrite(Pin, LOW); pinMode(Pin, OUTPUT); }
+#endif
+
+  void intr();                                                                                          // Interrupt handler, called on pin change
+  void sample(uint32_t now, bool closed);                                                               // Debounce and click logic, interrupts disabled
+  void timeouts(uint32_t now);                                                                          // Click and long press by time, interrupts disabled
+  inline void push(uint8_t type, uint32_t now) { events->push(type, (RotEncoderClock::TimeT)now); }
+
+  Events* events = nullptr;                                                                             // Event ring, nullptr if not started
+  int8_t intNum = NOT_AN_INTERRUPT;                                                                     // Interrupt number, or ROTENCODER_PIN_CHANGE
+  uint32_t debounce = ticks(10);                                                                        // Times in clock ticks
+  uint32_t dbl = ticks(300);
+  uint32_t lng = ticks(600);
+  uint32_t check = ticks(20);
+  uint32_t edgeT = 0;                                                                                   // Time of last accepted edge
+  uint32_t pullT = 0;                                                                                   // Time pull-up was turned on or off while held
+  volatile bool down = false;                                                                           // Debounced state, true when pressed
+  bool pull = true;                                                                                     // Pull-up on
+  bool longSent = false;                                                                                // Long press pushed for this press
+  bool clickPending = false;                                                                            // Click waiting for double click time
+};
+
+
+template <uint8_t Pin, class Events>
+bool RotEncoderButton<Pin, Events>::begin(Events& e) {                                                  // Start button, returns true if successful
+  if (events != nullptr) return false;                                                                  // Already started
+  events = &e;                                                                                          // Set before the vector can run, pin change is enabled by attach()
+  pull = true;
+  en();                                                                                                 // Input with pull-up, before the pin change state is latched
+  int8_t i = digitalPinToInterrupt(Pin);
+  if (RotEncoderISR::claim(i, this)) {                                                                  // External interrupt
+    intNum = i;
+#ifdef ROTENCODER_PCINT
+  } else if ((i == NOT_AN_INTERRUPT) && RotEncoderPcint::attach(Pin, this, &RotEncoderISR::call<RotEncoderButton>)) { // Pin change interrupt if enabled
+    intNum = ROTENCODER_PIN_CHANGE;
+#endif
+  } else {
+    events = nullptr;                                                                                   // Not started
+    return false;                                                                                       // No interrupt, or used by other instance
+  }
+  if (intNum >= 0) attachInterrupt(intNum, RotEncoderISR::vector<RotEncoderButton>(intNum), CHANGE);
+  return true;                                                                                          // Return true if ok
+}
+
+template <uint8_t Pin, class Events>
+bool RotEncoderButton<Pin, Events>::end() {                                                             // Stop button, returns true if successful
+  if (events == nullptr) return false;                                                                  // Return false if not started
+#ifdef ROTENCODER_PCINT
+  if (intNum == ROTENCODER_PIN_CHANGE) RotEncoderPcint::detach(this);
+#endif
+  if (intNum >= 0) {
+    RotEncoderISR::release(intNum, this);                                                               // Remove handle before detach
+    detachInterrupt(intNum);
+  }
+  intNum = NOT_AN_INTERRUPT;
+  events = nullptr;
+  return true;                                                                                          // Return true if ok
+}
+
+template <uint8_t Pin, class Events>
+void RotEncoderButton<Pin, Events>::intr() {                                                            // Interrupt handler, called on pin change
+  if (!pull) return;                                                                                    // Pin is driven low, no change from the switch
+  uint32_t now = RotEncoderClock::now32();
+  sample(now, rd());
+  timeouts(now);
+}
+
+template <uint8_t Pin, class Events>
+void RotEncoderButton<Pin, Events>::update() {                                                          // Main loop: Timeouts and release check
+  if (events == nullptr) return;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {                                                                   // Same state and ring as interrupt handler
+    uint32_t now = RotEncoderClock::now32();
+    if (down && !pull) {                                                                                // Held with pull-up off:
+      if (now - pullT >= check) { en(); pull = true; pullT = now; }                                     //   Pull-up on, release gives an interrupt
+    } else if (pull && (now - edgeT >= debounce)) {                                                     // Pull-up on and settled since last update():
+      sample(now, rd());                                                                                //   Takes a change lost in the debounce time, turns pull-up off if still held
+    }
+    timeouts(now);
+  }
+}
+
+template <uint8_t Pin, class Events>
+void RotEncoderButton<Pin, Events>::sample(uint32_t now, bool closed) {                                 // Debounce and click logic
+  if (closed == down) {                                                                                 // No change:
+    if (down && pull && (now - pullT > 0)) { di(); pull = false; pullT = now; }                         //   Still held, pull-up off until next release check
+    return;
+  }
+  if (now - edgeT < debounce) return;                                                                   // Bounce, ignored. update() takes the final state
+  edgeT = now;
+  down = closed;
+  if (closed) {                                                                                         // Press:
+    longSent = false;
+    di(); pull = false; pullT = now;                                                                    //   Pull-up off, no current and no bounce interrupts
+  } else if (!longSent) {                                                                               // Release after short press:
+    if (clickPending) { push(RotEncoderEvent::DoubleClick, now); clickPending = false; }                //   Second click
+    else clickPending = true;                                                                           //   First click, wait for double click time
+  }
+}
+
+template <uint8_t Pin, class Events>
+void RotEncoderButton<Pin, Events>::timeouts(uint32_t now) {                                            // Click and long press by time
+  if (down) {                                                                                           // Held:
+    if (!longSent && (now - edgeT >= lng)) {
+      if (clickPending) { push(RotEncoderEvent::Click, now); clickPending = false; }                    //   Click before this press
+      push(RotEncoderEvent::LongPress, now);
+      longSent = true;
+    }
+  } else if (clickPending && (now - edgeT >= dbl)) {                                                    // No second click in time:
+    push(RotEncoderEvent::Click, now);
+    clickPending = false;
+  }
+}
+
+#endif  // ROTENCODERBUTTON_H
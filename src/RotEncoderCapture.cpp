@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderCapture.cpp                                                                                                     //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "RotEncoder.h"
+
+#ifdef ROTENCODER_CAPTURE
+
+void* volatile RotEncoderCapture::handle = nullptr;                                                     // No instance attached
+RotEncoderCapture::CallT RotEncoderCapture::call = nullptr;
+
+
+bool RotEncoderCapture::attach(void* h, CallT c, uint8_t cs) {                                          // Start Timer1 capture, linked only if used
+  bool ok = false;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {                                                                   // Test and set must be atomic
+    if (handle == nullptr) {
+      call = c;
+      handle = h;
+      TCCR1A = 0;                                                                                       // Normal mode, free running
+      TCCR1B = _BV(ICNC1) | ((PINB & _BV(PINB0)) ? 0 : _BV(ICES1)) | cs;                                // Noise canceler, next edge of ICP1, prescaler
+      TIFR1 = _BV(ICF1);                                                                                // Clear old capture
+      TIMSK1 |= _BV(ICIE1);                                                                             // Enable capture interrupt
+      ok = true;
+    }
+  }
+  return ok;
+}
+
+void RotEncoderCapture::detach(const void* h) {                                                         // Stop Timer1 capture
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (handle == h) {
+      TIMSK1 &= ~_BV(ICIE1);
+      TCCR1B = 0;                                                                                       // Stop timer
+      handle = nullptr;
+    }
+  }
+}
+
+inline void RotEncoderCapture::dispatch() {                                                             // One edge of ICP1
+  uint16_t t = ICR1;                                                                                    // Time latched by hardware
+  uint8_t b = TCCR1B;
+  TCCR1B = b ^ _BV(ICES1);                                                                              // Capture the opposite edge next
+  TIFR1 = _BV(ICF1);                                                                                    // Changing the edge can set the flag, clear it
+  void* h = handle;
+  if (h != nullptr) call(h, t, b & _BV(ICES1));                                                         // Edge was rising if ICES1 was set
+}
+
+ISR(TIMER1_CAPT_vect) {                                                                                 // Timer1 capture vector
+  RotEncoderCapture::dispatch();
+}
+
+#endif
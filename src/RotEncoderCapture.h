@@ -0,0 +1,127 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderCapture.h                                                                                                       //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERCAPTURE_H
+#define ROTENCODERCAPTURE_H
+
+#include <Arduino.h>
+#include "RotEncoderIO.h"
+#include "RotEncoderCounter.h"
+#include "RotEncoderEvents.h"
+
+// Timestamped capture of encoder edges by Timer1 input capture (AVR with direct port I/O):
+//
+//   RotEncoderCapturePins<PinB, Size> has PinA on the input capture pin ICP1 (D8 on Uno, Nano and Pro Mini). Timer1
+//   latches its count in ICR1 at each edge of PinA in hardware, so the timestamp does not depend on the interrupt latency
+//   or on other interrupts. The capture vector toggles the edge select for the next edge, reads PinB, counts one step per
+//   edge of PinA (2 counts per cycle), and pushes a step event with the latched time into the event ring:
+//
+//   RotEncoderEvents<32> events;
+//   RotEncoderCapturePins<9, 32> shaft;                                                            // PinA = D8 (ICP1), PinB = D9, ring of 32
+//
+//   shaft.begin(events);
+//   ... events.drain(...), the time of each event is in Timer1 ticks, shaft.ticksPerSecond() ...
+//
+//   The event time is the 16-bit Timer1 count, with prescaler 8 by default (0.5 us at 16 MHz, wraps every 32.8 ms), not a
+//   RotEncoderClock timestamp. The noise canceler of the capture unit is on, which adds a constant delay of 4 cycles. This
+//   mode is for encoders without contact bounce, e.g. optical or magnetic motor encoders, and the pull-ups are always on.
+//   Timer1 can not be used by other code (Servo, PWM on D9 and D10) at the same time.
+
+#if defined(ROTENCODER_DIRECT_IO) && defined(ICR1) && defined(TIMSK1) && defined(ICIE1)
+  #define ROTENCODER_CAPTURE
+
+class RotEncoderCapture {                                                                               // Timer1 capture vector dispatcher
+public:
+  static constexpr uint8_t pin = 8;                                                                     // ICP1 is PB0 = D8
+  typedef void (*CallT)(void* handle, uint16_t time, bool rising);                                      // Function that handles an edge in handle
+  static bool attach(void* handle, CallT call, uint8_t cs);                                             // Start Timer1 capture with prescaler cs, returns false if used
+  static void detach(const void* handle);                                                               // Stop Timer1 capture
+  static void dispatch();                                                                               // Called from capture vector
+
+private:
+  static void* volatile handle;                                                                         // Instance, nullptr if unused
+  static CallT call;                                                                                    // Calls handler in instance type
+};
+
+template <uint8_t PinB, uint8_t Size = 16, class Counter = RotEncoderCounter>
+class RotEncoderCapturePins {                                                                           // PinA on ICP1, PinB on any pin
+public:
+  typedef typename Counter::ValueT PositionT;
+  PositionT getPosition() const { return counter.get(); }                                               // Returns position, lock-free
+  void setPosition(PositionT pos) { counter.set(pos); }                                                 // Set position
+  void reset() { counter.set(0); }                                                                      // Set position to 0
+  PositionT readAndResetDelta() { return counter.exchange(); }                                          // Returns steps since last call, and sets position to 0 or range end
+  PositionT getDistance(PositionT from, PositionT to) const { return counter.distance(from, to); }      // Steps between two positions, shorter way round a wrapping range
+
+  bool begin(RotEncoderEvents<Size>& ev, uint8_t cs = 2);                                               // Start capture, cs = Timer1 prescaler (1 = 1, 2 = 8, 3 = 64), returns true if successful
+  bool end();                                                                                           // Stop capture, returns true if successful
+  ~RotEncoderCapturePins() { end(); }                                                                   // Destructor should call end() to safely detach interrupts
+  uint32_t ticksPerSecond() const {                                                                     // Timer1 ticks per second, for event times
+    static const uint16_t prescale[] = { 1, 1, 8, 64, 256, 1024 };
+    return F_CPU / prescale[cs];
+  }
+
+private:
+  typedef RotEncoderPortIO<RotEncoderCapture::pin> A;
+  typedef RotEncoderPortIO<PinB> B;
+  static void call(void* h, uint16_t t, bool rising) { static_cast<RotEncoderCapturePins*>(h)->intr(t, rising); } // Called by capture vector
+
+  inline void intr(uint16_t t, bool rising) __attribute__((always_inline)) {                            // Capture interrupt, one edge of PinA
+    int8_t dir = ((!rising) == B::rd()) ? 1 : -1;                                                       // Up if both closed or both open after the edge
+    counter.add(dir);
+    events->push((dir > 0) ? RotEncoderEvent::StepUp : RotEncoderEvent::StepDn, t);                     // Latched time, not time of interrupt
+  }
+
+  Counter counter;                                                                                      // Position, updated in interrupts
+  RotEncoderEvents<Size>* events = nullptr;                                                             // Event ring, nullptr if not started
+  uint8_t cs = 2;                                                                                       // Timer1 prescaler
+};
+
+template <uint8_t PinB, uint8_t Size, class Counter>
+bool RotEncoderCapturePins<PinB, Size, Counter>::begin(RotEncoderEvents<Size>& ev, uint8_t c) {         // Start capture, returns true if successful
+  if ((events != nullptr) || (c < 1) || (c > 5)) return false;                                          // Already started, or no such prescaler
+  A::en(); B::en();                                                                                     // Inputs with pull-up, always on
+  events = &ev;
+  cs = c;
+  if (!RotEncoderCapture::attach(this, &call, c)) {                                                     // Timer1 capture used by other instance
+    events = nullptr;
+    return false;
+  }
+  return true;                                                                                          // Return true if ok
+}
+
+template <uint8_t PinB, uint8_t Size, class Counter>
+bool RotEncoderCapturePins<PinB, Size, Counter>::end() {                                                // Stop capture, returns true if successful
+  if (events == nullptr) return false;                                                                  // Return false if not started
+  RotEncoderCapture::detach(this);
+  events = nullptr;
+  return true;                                                                                          // Return true if ok
+}
+
+#endif
+
+#endif  // ROTENCODERCAPTURE_H
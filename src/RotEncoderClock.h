@@ -0,0 +1,82 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderClock.h                                                                                                         //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERCLOCK_H
+#define ROTENCODERCLOCK_H
+
+#include <Arduino.h>
+#include "RotEncoderAtomic.h"  // Atomic blocks on all architectures
+
+// Cheap timestamps for the interrupt handler:
+//
+//   On AVR the timestamp is read directly from Timer0, which the Arduino core runs for millis() and micros() with
+//   prescaler 64 (4 us per tick at 16 MHz). The low byte of the overflow count and TCNT0 gives a 16-bit timestamp that
+//   wraps every 65536 ticks (262 ms at 16 MHz). This is a few instructions, compared to micros() which does 32-bit math.
+//   now() must be called with interrupts disabled, e.g. from the interrupt handler.
+//
+//   now32() gives the full 32-bit timestamp (wraps after 4.7 hours at 16 MHz) for interval measurements, at the cost of
+//   reading the 4 byte overflow count. read32() can be called from the main loop, and disables interrupts for a few cycles.
+//
+//   On other targets micros() is used, which reads a hardware timer or cycle counter on most 32-bit cores.
+
+#if defined(__AVR__) && defined(TCNT0) && defined(TIFR0) && defined(TOV0)
+extern volatile unsigned long timer0_overflow_count;                                                    // Timer0 overflow counter from Arduino core (wiring.c)
+
+struct RotEncoderClock {                                                                                // Timestamp from Timer0
+  typedef uint16_t TimeT;                                                                               // 16-bit timestamp, wraps every 65536 ticks
+  static constexpr uint32_t ticksPerSecond = F_CPU / 64;                                                // Timer0 prescaler 64
+
+  static inline TimeT now() __attribute__((always_inline)) {                                            // Call with interrupts disabled
+    uint8_t t = TCNT0;                                                                                  // Read timer
+    uint8_t h = (uint8_t)timer0_overflow_count;                                                         // Low byte of overflow count
+    if ((TIFR0 & _BV(TOV0)) && (t < 255)) h++;                                                          // Overflow pending, not yet counted
+    return ((TimeT)h << 8) | t;
+  }
+  static inline uint32_t now32() __attribute__((always_inline)) {                                       // Call with interrupts disabled
+    uint8_t t = TCNT0;                                                                                  // Read timer
+    uint32_t h = timer0_overflow_count;                                                                 // Full overflow count
+    if ((TIFR0 & _BV(TOV0)) && (t < 255)) h++;                                                          // Overflow pending, not yet counted
+    return (h << 8) | t;
+  }
+  static uint32_t read32() {                                                                            // now32() from main loop
+    uint32_t t;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { t = now32(); }
+    return t;
+  }
+};
+#else
+struct RotEncoderClock {                                                                                // Timestamp from micros()
+  typedef uint32_t TimeT;                                                                               // 32-bit timestamp in us
+  static constexpr uint32_t ticksPerSecond = 1000000UL;
+
+  static inline TimeT now() __attribute__((always_inline)) { return micros(); }
+  static inline uint32_t now32() __attribute__((always_inline)) { return micros(); }
+  static inline uint32_t read32() { return micros(); }
+};
+#endif
+
+#endif  // ROTENCODERCLOCK_H
@@ -0,0 +1,236 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderCounter.h                                                                                                       //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERCOUNTER_H
+#define ROTENCODERCOUNTER_H
+
+#include <Arduino.h>
+#include "RotEncoderAtomic.h"
+
+#ifndef ROTENCODER_ATOMIC_SIZE                                                                          // Largest size in bytes that is read and written in one instruction
+  #if defined(__AVR__)
+    #define ROTENCODER_ATOMIC_SIZE 1                                                                    //   AVR: 8-bit
+  #else
+    #define ROTENCODER_ATOMIC_SIZE 4                                                                    //   32-bit: Aligned 32-bit loads and stores
+  #endif
+#endif
+
+// Limits and unsigned type of the counter types, without <limits> and <type_traits> (not available on AVR):
+
+template <class T> struct RotEncoderLimits;
+template <class T, class U, bool Signed> struct RotEncoderLimitsT {
+  typedef U UnsignedT;                                                                                  // Unsigned type of same size, for wrapping arithmetic
+  static constexpr T max = Signed ? (T)((U)~(U)0 >> 1) : (T)~(U)0;                                      // Largest value
+  static constexpr T min = Signed ? (T)(-max - 1) : (T)0;                                               // Smallest value
+};
+template <class T, class U, bool Signed> constexpr T RotEncoderLimitsT<T, U, Signed>::max;
+template <class T, class U, bool Signed> constexpr T RotEncoderLimitsT<T, U, Signed>::min;
+template <> struct RotEncoderLimits<signed char> : RotEncoderLimitsT<signed char, unsigned char, true> { };
+template <> struct RotEncoderLimits<unsigned char> : RotEncoderLimitsT<unsigned char, unsigned char, false> { };
+template <> struct RotEncoderLimits<short> : RotEncoderLimitsT<short, unsigned short, true> { };
+template <> struct RotEncoderLimits<unsigned short> : RotEncoderLimitsT<unsigned short, unsigned short, false> { };
+template <> struct RotEncoderLimits<int> : RotEncoderLimitsT<int, unsigned int, true> { };
+template <> struct RotEncoderLimits<unsigned int> : RotEncoderLimitsT<unsigned int, unsigned int, false> { };
+template <> struct RotEncoderLimits<long> : RotEncoderLimitsT<long, unsigned long, true> { };
+template <> struct RotEncoderLimits<unsigned long> : RotEncoderLimitsT<unsigned long, unsigned long, false> { };
+template <> struct RotEncoderLimits<long long> : RotEncoderLimitsT<long long, unsigned long long, true> { };
+template <> struct RotEncoderLimits<unsigned long long> : RotEncoderLimitsT<unsigned long long, unsigned long long, false> { };
+
+
+// Overflow policies, select what happens when position passes the limits of the counter type:
+//
+//   RotEncoderWrap:             Wraps around, e.g. 127 + 1 = -128 for int8_t. This is the behavior of the original long.
+//   RotEncoderSaturate:         Stops at the limits of the counter type.
+//   RotEncoderClamp<Min, Max>:  Stops at Min and Max, the range must fit in the counter type.
+//   RotEncoderRange<T>:         Range set at run time by setRange(min, max, wrap), stops at or wraps around the ends.
+//
+//   distance(from, to) returns the steps from one position to another. In a wrapping range it is the shorter way round,
+//   so a step from max to min is +1.
+
+struct RotEncoderWrap {                                                                                 // Wrap around at the limits
+  template <class T> static inline __attribute__((always_inline)) T add(T v, int8_t n) {
+    typedef typename RotEncoderLimits<T>::UnsignedT U;
+    return (T)((U)v + (U)n);                                                                            // Unsigned arithmetic, no signed overflow
+  }
+  template <class T> static inline T limit(T v) { return v; }                                           // Returns v moved into range, all values are valid
+  template <class T> static inline T distance(T from, T to) {                                           // Returns steps from position from to position to
+    typedef typename RotEncoderLimits<T>::UnsignedT U;
+    return (T)((U)to - (U)from);                                                                        // With wrap around of T
+  }
+};
+
+struct RotEncoderSaturate {                                                                             // Stop at the limits of the counter type
+  template <class T> static inline __attribute__((always_inline)) T add(T v, int8_t n) {
+    typedef RotEncoderLimits<T> L;
+    if (n >= 0) return (v > (T)(L::max - n)) ? L::max : (T)(v + n);
+    return (v < (T)(L::min - n)) ? L::min : (T)(v + n);
+  }
+  template <class T> static inline T limit(T v) { return v; }
+  template <class T> static inline T distance(T from, T to) { return RotEncoderWrap::distance(from, to); }
+};
+
+template <long Min, long Max>
+struct RotEncoderClamp {                                                                                // Stop at Min and Max
+  static_assert(Min < Max, "RotEncoderClamp: Min must be less than Max");
+  template <class T> static inline __attribute__((always_inline)) T add(T v, int8_t n) {
+    static_assert(((T)Min == Min) && ((T)Max == Max), "RotEncoderClamp: Range does not fit in counter type");
+    T r = RotEncoderSaturate::add(v, n);                                                                // No overflow of T
+    return (r < (T)Min) ? (T)Min : ((r > (T)Max) ? (T)Max : r);                                         // Compares in the width of T
+  }
+  template <class T> static inline T limit(T v) { return (v < (T)Min) ? (T)Min : ((v > (T)Max) ? (T)Max : v); }
+  template <class T> static inline T distance(T from, T to) { return RotEncoderWrap::distance(from, to); }
+};
+
+template <class T>
+class RotEncoderRange {                                                                                 // Range set at run time, constant cost in interrupts
+public:
+  inline __attribute__((always_inline)) T add(T v, int8_t n) const {
+    typedef typename RotEncoderLimits<T>::UnsignedT U;                                                  // Offsets from min, no overflow of T
+    U o = (U)v - (U)min;                                                                                // Offset of v in range
+    U span = (U)max - (U)min;                                                                           // Largest offset, range has span + 1 values
+    if (n >= 0) {
+      U d = (U)n;
+      if (d <= (U)(span - o)) return (T)((U)v + d);                                                     // In range
+      if (!wrap) return max;                                                                            // Above range: Stop at max
+      U w = (U)(d - (U)(span - o) - 1);                                                                 //   Wrap around, offset from min
+      return (w > span) ? max : (T)((U)min + w);                                                        //   Stop at max if step is larger than range
+    }
+    U d = (U)(-(int)n);
+    if (d <= o) return (T)((U)v - d);                                                                   // In range
+    if (!wrap) return min;                                                                              // Below range: Stop at min
+    U w = (U)(d - o - 1);                                                                               //   Wrap around, offset from max
+    return (w > span) ? min : (T)((U)max - w);
+  }
+
+  inline void set(T lo, T hi, bool w) {                                                                 // Set range, called with interrupts disabled
+    if (lo > hi) { T t = lo; lo = hi; hi = t; }
+    min = lo; max = hi; wrap = w;
+  }
+  inline T limit(T v) const { return (v < min) ? min : ((v > max) ? max : v); }                         // Returns v moved into range
+  T distance(T from, T to) const {                                                                      // Returns steps from position from to position to
+    typedef typename RotEncoderLimits<T>::UnsignedT U;
+    U d = (U)((U)to - (U)from);
+    U span = (U)max - (U)min;
+    if (!wrap || (span == (U)~(U)0)) return (T)d;                                                       // Stops at the ends, or wraps as the full type
+    U n = (U)(span + 1);                                                                                // Wrap around the range: The shorter way, in (-n/2, n/2]
+    if ((U)((U)to - (U)min) < (U)((U)from - (U)min)) d = (U)(d + n);                                    //   Passed the ends, d is the offset difference plus n
+    return (d > (U)(n / 2)) ? (T)(d - n) : (T)d;
+  }
+
+private:
+  T min = RotEncoderLimits<T>::min;                                                                     // Full range of T until setRange()
+  T max = RotEncoderLimits<T>::max;
+  bool wrap = false;                                                                                    // Stop at the ends
+};
+
+
+// Position counter, written by an interrupt handler and read lock-free by the main loop:
+//
+//   Interrupts are never disabled by get(). If position can not be read in one instruction, the sequence counter is read
+//   before and after position. The interrupt handler changes seq with every change of position, so a torn read is detected
+//   and retried. The interrupt handler is never interrupted by get(), so the retry loop can only repeat while the encoder
+//   keeps generating interrupts faster than the few cycles needed for the read.
+//
+//   T is the counter type and Policy the overflow policy. A counter that fits in ROTENCODER_ATOMIC_SIZE (int8_t on AVR) is
+//   updated and read with single instructions, and has no sequence counter:
+//
+//   RotEncoderPinsT<2, 3, RotEncoderStdDecoder, void, RotEncoderCounterT<int8_t, RotEncoderClamp<-100, 100> > > knob;
+//
+//   The policy and the sequence counter are base classes of the counter, so a policy without state (all except
+//   RotEncoderRange) and an unused sequence counter take no memory.
+
+template <bool Used> struct RotEncoderSeq {                                                             // Sequence counter for counters wider than one load
+  inline void changed() __attribute__((always_inline)) { seq++; }
+  inline uint8_t read() const __attribute__((always_inline)) { return seq; }
+private:
+  volatile uint8_t seq = 0;                                                                             // Changed every time position is changed
+};
+template <> struct RotEncoderSeq<false> {                                                               // Not used, empty base class takes no memory
+  inline void changed() __attribute__((always_inline)) { }
+  inline uint8_t read() const __attribute__((always_inline)) { return 0; }
+};
+
+template <class T = long, class Policy = RotEncoderWrap>
+class RotEncoderCounterT : private Policy, private RotEncoderSeq<(sizeof(T) > ROTENCODER_ATOMIC_SIZE)> { // Position with lock-free read
+  typedef RotEncoderSeq<(sizeof(T) > ROTENCODER_ATOMIC_SIZE)> Seq;
+public:
+  typedef T ValueT;                                                                                     // Counter type
+
+  inline void add(int8_t n) __attribute__((always_inline)) {                                            // Interrupt handler: Add n to position
+    position = Policy::add((T)position, n);
+    Seq::changed();                                                                                     // Tell readers position changed, removed if T is atomic
+  }
+
+  void set(T v) {                                                                                       // Main loop: Set position, moved into range of policy
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      position = Policy::limit(v);
+      Seq::changed();
+    }
+  }
+
+  T exchange() {                                                                                        // Main loop: Returns steps from origin and sets position to origin
+    // The origin is 0, or the end of the range nearest to 0 if the range does not include 0, the same as set(0). In a
+    // wrapping range the steps are only unambiguous if less than half the range is turned between two calls.
+    T o = Policy::limit((T)0);
+    T v;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {                                                                 // Step between read and clear is not lost
+      v = position;
+      position = o;
+      Seq::changed();
+    }
+    return Policy::distance(o, v);                                                                      // Steps, the shorter way round a wrapping range
+  }
+
+  inline T distance(T from, T to) const { return Policy::distance(from, to); }                          // Steps between two positions, see policies above
+
+  void setRange(T min, T max, bool wrap = false) {                                                      // Main loop: Set range, RotEncoderRange policy only
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {                                                                 // Range and position are used by interrupt handler
+      Policy::set(min, max, wrap);
+      position = Policy::limit(position);                                                               // Position is always in range
+      Seq::changed();
+    }
+  }
+
+  inline T get() const {                                                                                // Main loop: Returns position
+    if (sizeof(T) <= ROTENCODER_ATOMIC_SIZE) return position;                                           // Single load is atomic, resolved at compile time
+    T pos;
+    uint8_t s;
+    do {
+      s = Seq::read();                                                                                  // Read sequence counter
+      pos = position;                                                                                   // Read position, may be torn by an interrupt
+    } while (s != Seq::read());                                                                         // Retry if an interrupt changed position during read
+    return pos;                                                                                         // and return it
+  }
+
+private:
+  volatile T position = 0;                                                                              // Position, volatile, updated in interrupts
+};
+
+template <class T = long> using RotEncoderRangeCounter = RotEncoderCounterT<T, RotEncoderRange<T> >;    // Counter with setRange()
+typedef RotEncoderCounterT<> RotEncoderCounter;                                                         // Default counter, long with wrap around
+
+#endif  // ROTENCODERCOUNTER_H
@@ -0,0 +1,214 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderDecoder.h                                                                                                       //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERDECODER_H
+#define ROTENCODERDECODER_H
+
+#include <Arduino.h>
+#include "RotEncoderAtomic.h"  // Atomic blocks on all architectures
+
+// Decoders for the rotary encoder state machine:
+//
+//   A decoder gets the pins read by rdPins() (bit 1 = PinA, bit 0 = PinB, high when switch closed) and returns a set of
+//   result flags. The interrupt handler in RotEncoderT turns off the pull-ups and counts the position from the flags, so a
+//   decoder holds only the state machine and no I/O. Select the decoder with the Decoder template parameter of RotEncoderT.
+//
+//   RotEncoderStdDecoder:   Reads the pins until two consecutive reads agree, then walks the state machine. This is the
+//                           original decoder and the default.
+//   RotEncoderTableDecoder: Reads the pins once, and looks up step and next state in a 16 entry table in flash. Runs in
+//                           bounded time also under heavy bounce.
+//   RotEncoderQuadDecoder<Res>: Quadrature decoder with 2 or 4 counts per cycle, see below.
+//
+//   RotEncoderResDecoder<Res> selects the decoder for a resolution of 1, 2 or 4 counts per cycle at compile time.
+
+struct RotEncoderDecoder {                                                                              // Flags shared by all decoders
+  enum : uint8_t { PinB = 0x01, PinA = 0x02 };                                                          // Bits in pins from rdPins()
+  enum : uint8_t { Up = 0x01, Dn = 0x02, DiA = 0x04, DiB = 0x08 };                                      // Result: Count up/dn, disable PinA/PinB pull-up
+  enum : uint8_t { Err = 0x10, Two = 0x20 };                                                            // Result: Illegal jump, count two steps (Up or Dn)
+  static constexpr bool inferSteps = false;                                                             // True if decoder can return Two
+  inline void init(uint8_t) __attribute__((always_inline)) { }                                          // Load state from pins at begin(), empty if not needed
+};
+
+
+class RotEncoderStdDecoder : public RotEncoderDecoder {                                                 // Original decoder with lrflg and cntflg
+public:
+  static constexpr bool stableRead = true;                                                              // Retry reading until stable
+
+  inline uint8_t next(uint8_t pins) __attribute__((always_inline)) {                                    // Returns result flags for pins
+    // This is code for rotary switch:
+    if (pins & PinA) {                                                                                  // Switch(inA,inB) case:
+      if (pins & PinB) {                                                                                //   InA on and InB on:
+        cntflg = true;                                                                                  //     Set count flag
+        return 0;
+      } else {                                                                                          //   InA on and InB off:
+        uint8_t r = ((!lrflg)&&cntflg) ? (DiA | Up) : DiA;                                              //     Turn off pull-up current for inA, count up if oposite position
+        lrflg = true;                                                                                   //     Set lrflag to true for this position (SW1 on, SW0 off)
+        cntflg = false;                                                                                 //     Clear count flag
+        return r;
+      }
+    } else {
+      if (pins & PinB) {                                                                                //   InA off and InB on:
+        uint8_t r = (lrflg&&cntflg) ? (DiB | Dn) : DiB;                                                 //     Turn off pull-up current for inB, count dn if oposite position
+        lrflg = false;                                                                                  //     Set lrflag to false for this position (SW1 off, SW0 on)
+        cntflg = false;                                                                                 //     Clear count flag
+        return r;
+      } else {                                                                                          //   InA off and InB off:
+        return 0;                                                                                       //     Do nothing. cntflg is false, unless bounce on common pin
+      }                                                                                                 //       (Do nothing: Bounceing on common pin is handled)
+    }
+  }
+
+private:
+  bool cntflg = false;                                                                                  // Set true to count up, default is not count
+  bool lrflg = false;                                                                                   // Left or right side last
+};
+
+
+// Table decoder:
+//
+//   The state is lrflg (bit 1) and cntflg (bit 0) of the original decoder. Index = state << 2 | pins, and each entry holds
+//   the next state in the high nibble and the result flags in the low nibble. The table is generated at compile time by
+//   entry() from the same rules as RotEncoderStdDecoder, so both decoders count identically:
+//
+//     pins  A on, B on:   cntflg = 1
+//     pins  A on, B off:  DiA, Up if state = (lrflg 0, cntflg 1), next state = (1, 0)
+//     pins  A off, B on:  DiB, Dn if state = (lrflg 1, cntflg 1), next state = (0, 0)
+//     pins  A off, B off: No change, bounce on the common pin is ignored
+//
+//   Both pins are read once, without retry. A reading taken while a contact bounces gives a valid state for that instant,
+//   and the next edge triggers a new interrupt that reads the final state. A pin that is still rising after its pull-up is
+//   enabled gives its own CHANGE interrupt the same way.
+
+class RotEncoderTableDecoder : public RotEncoderDecoder {                                               // Single read, table driven decoder
+public:
+  static constexpr bool stableRead = false;                                                             // Read pins only once
+
+  inline uint8_t next(uint8_t pins) __attribute__((always_inline)) {                                    // Returns result flags for pins
+    uint8_t e = pgm_read_byte(&table[(state << 2) | pins]);                                             // Lookup in flash
+    state = e >> 4;                                                                                     // Next state in high nibble (swap on AVR)
+    return e & 0x0F;                                                                                    // Result flags in low nibble
+  }
+
+  static constexpr uint8_t entry(uint8_t i) {                                                           // Table entry for index i = state << 2 | pins
+    return ((i & 3) == (PinA | PinB)) ? (((((i >> 2) & 2) | 1) << 4)) :                                 //   A on, B on: Set cntflg
+           ((i & 3) == PinA) ? ((2 << 4) | DiA | (((i >> 2) == 1) ? Up : 0)) :                          //   A on, B off: lrflg = 1, count up if (0, 1)
+           ((i & 3) == PinB) ? ((0 << 4) | DiB | (((i >> 2) == 3) ? Dn : 0)) :                          //   A off, B on: lrflg = 0, count dn if (1, 1)
+           (((i >> 2) & 3) << 4);                                                                       //   A off, B off: No change
+  }
+
+private:
+  static const uint8_t table[16];                                                                       // Table in flash, defined in RotEncoder.cpp
+  uint8_t state = 0;                                                                                    // lrflg (bit 1) and cntflg (bit 0)
+};
+
+
+// Quadrature decoder with 2 or 4 counts per cycle:
+//
+//   Each change of the pins is looked up in a 16 entry table in flash, index = last pins << 2 | pins, which gives one
+//   quarter step up or down, or nothing for no change and for a jump over a state (both pins changed). Up is the sequence
+//   0 -> B -> A+B -> A -> 0, the same direction as RotEncoderStdDecoder.
+//
+//   Res = 4: Counts every quarter step, for optical and high resolution encoders.
+//   Res = 2: Counts when both pins are equal (off or on), for detented encoders with two steps per click. Quarter steps
+//            are added between these states, so bouncing back and forth between two states is not counted.
+//
+//   This decoder sees every edge, so the pull-ups are never turned off. This is also safe for encoders with push-pull
+//   outputs. The pins are read once, so the time is bounded. begin() loads the decoder with the pins by init(), so the first
+//   edge is decoded from the actual rest position of the encoder.
+//
+//   A jump over a state means an edge came before the interrupt of the last edge was handled, and a step is lost. The
+//   table marks these with Err, and the decoder counts them in getErrors() (also getErrors() of the encoder), e.g. to find
+//   the speed where counts are lost. With Infer = true, a jump is counted as two quarter steps in the last direction, which
+//   is the most likely movement if the encoder turns fast. Bounce on the common pin is also a jump, so use Infer only with
+//   encoders without contact bounce, e.g. optical encoders. RotEncoderStdDecoder does not count jumps: There, both pins
+//   going off at once is bounce on the common pin.
+
+class RotEncoderQuadTable : public RotEncoderDecoder {                                                  // Quarter step table, shared by all resolutions
+public:
+  static constexpr uint8_t entry(uint8_t i) {                                                           // Table entry for index i = last << 2 | pins
+    return (gray(i & 3) == ((gray(i >> 2) + 1) & 3)) ? Up :                                             //   Next state in up sequence
+           (gray(i & 3) == ((gray(i >> 2) + 3) & 3)) ? Dn :                                             //   Next state in down sequence
+           (gray(i & 3) == ((gray(i >> 2) + 2) & 3)) ? Err : 0;                                         //   Jump over a state, else no change
+  }
+
+protected:
+  static constexpr uint8_t gray(uint8_t pins) {                                                         // Position of pins in up sequence
+    return (pins == 0) ? 0 : ((pins == PinB) ? 1 : ((pins == (PinA | PinB)) ? 2 : 3));
+  }
+  static const uint8_t table[16];                                                                       // Table in flash, defined in RotEncoder.cpp
+};
+
+template <uint8_t Res, bool Infer = false>
+class RotEncoderQuadDecoder : public RotEncoderQuadTable {                                              // Quadrature decoder, Res = 2 or 4 counts per cycle
+  static_assert((Res == 2) || (Res == 4), "RotEncoderQuadDecoder: Res must be 2 or 4, use RotEncoderStdDecoder for 1");
+
+public:
+  static constexpr bool stableRead = false;                                                             // Read pins only once
+  static constexpr bool inferSteps = Infer && (Res == 4);                                               // Jump is two counts
+
+  inline void init(uint8_t pins) __attribute__((always_inline)) { last = pins; acc = 0; }               // Load actual pins at begin(), first edge is decoded from them
+  inline uint8_t next(uint8_t pins) __attribute__((always_inline)) {                                    // Returns result flags for pins
+    uint8_t r = pgm_read_byte(&table[(last << 2) | pins]);                                              // Quarter step up, down, none or jump
+    last = pins;
+    if (r & Err) {                                                                                      // Jump over a state, a step is lost
+      errors++;
+      if (!Infer || !dir) return Err;                                                                   //   Direction unknown
+      r = dir | Two | Err;                                                                              //   Two quarter steps in last direction
+    } else if (Infer && r) {
+      dir = r;                                                                                          // Last direction, Up or Dn
+    }
+    if (Res == 4) return r;                                                                             // Count every quarter step, resolved at compile time
+    if (r & Up) acc += (r & Two) ? 2 : 1;                                                               // Add quarter steps
+    if (r & Dn) acc -= (r & Two) ? 2 : 1;
+    if (((pins == 0) || (pins == (PinA | PinB))) && (acc != 0)) {                                       // Count when both pins are equal
+      r = (acc > 0) ? Up : Dn;
+      acc = 0;
+      return r;
+    }
+    return 0;
+  }
+
+  uint16_t getErrors() const {                                                                          // Main loop: Returns number of jumps
+    uint16_t n;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { n = errors; }
+    return n;
+  }
+  void resetErrors() { ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { errors = 0; } }                              // Main loop: Clears number of jumps
+
+private:
+  volatile uint16_t errors = 0;                                                                         // Jumps over a state, wraps around
+  uint8_t dir = 0;                                                                                      // Last direction Up or Dn, 0 if unknown, Infer only
+  uint8_t last = 0;                                                                                     // Last pins read
+  int8_t acc = 0;                                                                                       // Quarter steps since last count, Res = 2 only
+};
+
+
+template <uint8_t Res> struct RotEncoderResSelect { typedef RotEncoderQuadDecoder<Res> type; };         // Decoder for Res counts per cycle
+template <> struct RotEncoderResSelect<1> { typedef RotEncoderStdDecoder type; };                       // 1 count per cycle, with dynamic pull-ups
+template <uint8_t Res> using RotEncoderResDecoder = typename RotEncoderResSelect<Res>::type;
+
+#endif  // ROTENCODERDECODER_H
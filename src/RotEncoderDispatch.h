@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderDispatch.h                                                                                                      //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERDISPATCH_H
+#define ROTENCODERDISPATCH_H
+
+#include <Arduino.h>
+#include "RotEncoderCounter.h"
+
+// Position changes from one read, sent to several listeners in the main loop:
+//
+//   RotEncoderDispatcher<Encoder, N> reads the position of the encoder once per dispatch(), and calls each of up to N
+//   listeners with the change since the last dispatch() and the position. All steps between two calls are coalesced into
+//   one delta, and all listeners get the same values, from the same read, however many there are. The listeners are
+//   function pointers with a context pointer in a fixed array, no heap is used:
+//
+//   RotEncoderDispatcher<Knob, 4> knobEvents;
+//
+//   void onVolume(void* ctx, long delta, long pos) { ... }
+//
+//   void setup() {
+//     knob.begin();
+//     knobEvents.begin(knob);
+//     knobEvents.add(&onVolume);
+//     knobEvents.add(&Logger::onKnob, &logger);                                                    // Static member with object as context
+//   }
+//   void loop() {
+//     knobEvents.dispatch();                                                                        // Once per loop
+//   }
+//
+//   The delta is the getDistance() of the encoder, so a step from max to min of a wrapping RotEncoderRange is +1, not the
+//   size of the range. Encoders without getDistance() (RotEncoderSampled, RotEncoderHw) use the wrap around of the
+//   position type. A position set by setPosition() is seen as a change too. Listeners are called from the main loop, and may add or remove listeners.
+
+template <class Encoder, uint8_t N = 4>
+class RotEncoderDispatcher {                                                                            // Fan-out of position changes
+  static const Encoder& encoder();                                                                      // Declaration only, for the position type
+public:
+  typedef decltype(encoder().getPosition()) PositionT;                                                  // Position type of encoder
+  typedef void (*ListenerT)(void* ctx, PositionT delta, PositionT pos);                                 // Listener, called with change and position
+
+  void begin(Encoder& e) { enc = &e; last = e.getPosition(); }                                          // Start with actual position, no change
+  bool add(ListenerT fn, void* ctx = nullptr);                                                          // Add listener, returns false if full
+  bool remove(ListenerT fn, void* ctx = nullptr);                                                       // Remove listener, returns false if not found
+  PositionT dispatch();                                                                                 // Main loop: Read once, call listeners if changed, returns delta
+
+private:
+  typedef typename RotEncoderLimits<PositionT>::UnsignedT U;
+  template <class E> static auto distance(const E& e, PositionT from, PositionT to, int) -> decltype(e.getDistance(from, to)) { // Steps of the counter policy, if the encoder has getDistance()
+    return e.getDistance(from, to);
+  }
+  template <class E> static PositionT distance(const E&, PositionT from, PositionT to, long) {          // Otherwise wrap around of the position type
+    return (PositionT)((U)to - (U)from);
+  }
+  struct Listener {
+    ListenerT fn;                                                                                       //   Function, nullptr if unused
+    void* ctx;                                                                                          //   Context
+  };
+  Listener listeners[N] = {};
+  Encoder* enc = nullptr;                                                                               // Encoder, nullptr if not started
+  PositionT last = 0;                                                                                   // Position at last dispatch()
+};
+
+template <class Encoder, uint8_t N>
+bool RotEncoderDispatcher<Encoder, N>::add(ListenerT fn, void* ctx) {                                   // Add listener, returns false if full
+  for (uint8_t i = 0; i < N; i++) {
+    if (listeners[i].fn == nullptr) {
+      listeners[i].fn = fn;
+      listeners[i].ctx = ctx;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class Encoder, uint8_t N>
+bool RotEncoderDispatcher<Encoder, N>::remove(ListenerT fn, void* ctx) {                                // Remove listener, returns false if not found
+  for (uint8_t i = 0; i < N; i++) {
+    if ((listeners[i].fn == fn) && (listeners[i].ctx == ctx)) {
+      listeners[i].fn = nullptr;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class Encoder, uint8_t N>
+typename RotEncoderDispatcher<Encoder, N>::PositionT RotEncoderDispatcher<Encoder, N>::dispatch() {     // Read once, call listeners if changed
+  if (enc == nullptr) return 0;                                                                         // Not started
+  PositionT pos = enc->getPosition();                                                                   // One read for all listeners
+  PositionT delta = distance(*enc, last, pos, 0);                                                       // Change, int overload first
+  if (delta == 0) return 0;
+  last = pos;
+  for (uint8_t i = 0; i < N; i++) {
+    ListenerT fn = listeners[i].fn;
+    if (fn != nullptr) fn(listeners[i].ctx, delta, pos);
+  }
+  return delta;
+}
+
+#endif  // ROTENCODERDISPATCH_H
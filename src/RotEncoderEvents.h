@@ -0,0 +1,100 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderEvents.h                                                                                                        //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODEREVENTS_H
+#define ROTENCODEREVENTS_H
+
+#include <Arduino.h>
+#include "RotEncoderClock.h"
+
+// Event ring buffer from the interrupt handler to the main loop:
+//
+//   RotEncoderEvents<Size> is a fixed size single-producer/single-consumer ring buffer. The interrupt handler is the only
+//   producer and calls push(), the main loop is the only consumer and calls drain(). Head is only written by the producer
+//   and tail only by the consumer, and both are 8-bit, so no interrupts are disabled. If the ring is full the event is
+//   dropped and counted in getOverflows().
+//
+//   Size must be a power of 2, max. 128. push() is O(1): compare, store and increment.
+//
+//   class Knob : public RotEncoderPinsT<2, 3, RotEncoderStdDecoder, Knob> {
+//   public:
+//     RotEncoderEvents<16> events;
+//     void onStep(int8_t dir) { events.step(dir); }                                                  // Hook called by intr()
+//   };
+
+struct RotEncoderEvent {                                                                                // Compact event
+  enum : uint8_t { StepUp = 1, StepDn = 2, Click = 3, DoubleClick = 4, LongPress = 5 };                 // Event types, button events from RotEncoderButton
+  uint8_t type;                                                                                         // Event type
+  RotEncoderClock::TimeT time;                                                                          // Timestamp from RotEncoderClock::now()
+};
+
+template <uint8_t Size>
+class RotEncoderEvents {                                                                                // SPSC lock-free ring buffer of events
+  static_assert((Size >= 2) && (Size <= 128) && ((Size & (Size - 1)) == 0), "RotEncoderEvents: Size must be a power of 2, max. 128");
+
+public:
+  inline bool push(uint8_t type, RotEncoderClock::TimeT time) __attribute__((always_inline)) {          // Producer: Add event, returns false if full
+    uint8_t h = head;
+    if ((uint8_t)(h - tail) >= Size) {                                                                  // Ring full
+      overflows++;                                                                                      //   Count lost event
+      return false;
+    }
+    RotEncoderEvent& e = buf[h & (Size - 1)];
+    e.type = type; e.time = time;
+    asm volatile("" ::: "memory");                                                                      // Compiler barrier, event is written before head
+    head = h + 1;                                                                                       // Publish event after it is written
+    return true;
+  }
+  inline bool step(int8_t dir) __attribute__((always_inline)) {                                         // Producer: Add step event with timestamp, for onStep()
+    return push((dir > 0) ? RotEncoderEvent::StepUp : RotEncoderEvent::StepDn, RotEncoderClock::now());
+  }
+
+  uint8_t drain(RotEncoderEvent* out, uint8_t max) {                                                    // Consumer: Move up to max events to out, returns number moved
+    uint8_t t = tail;
+    uint8_t n = head - t;                                                                               // Events available
+    if (n > max) n = max;
+    asm volatile("" ::: "memory");                                                                      // Compiler barrier, events are read after head
+    for (uint8_t i = 0; i < n; i++) out[i] = buf[(uint8_t)(t + i) & (Size - 1)];
+    asm volatile("" ::: "memory");                                                                      // Compiler barrier, events are read before slots are released
+    tail = t + n;                                                                                       // Release slots after they are read
+    return n;
+  }
+  uint8_t available() const { return (uint8_t)(head - tail); }                                          // Consumer: Number of events in ring
+  uint16_t getOverflows() const {                                                                       // Number of events lost because ring was full
+    uint16_t n;
+    do { n = overflows; } while (n != overflows);                                                       // Read twice, retry if changed by interrupt
+    return n;
+  }
+
+private:
+  RotEncoderEvent buf[Size];                                                                            // Events
+  volatile uint8_t head = 0;                                                                            // Next slot to write, only written by producer
+  volatile uint8_t tail = 0;                                                                            // Next slot to read, only written by consumer
+  volatile uint16_t overflows = 0;                                                                      // Lost events, only written by producer
+};
+
+#endif  // ROTENCODEREVENTS_H
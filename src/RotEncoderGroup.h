@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderGroup.h                                                                                                         //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERGROUP_H
+#define ROTENCODERGROUP_H
+
+#include <Arduino.h>
+#include "RotEncoderAtomic.h"  // Atomic blocks on all architectures
+#include "RotEncoderClock.h"  // Timestamps of the steps and the snapshot
+
+// Positions of several encoders at one instant, e.g. the axes of an XY jog:
+//
+//   Two getPosition() calls one after the other can be torn by a step of the second encoder between the reads, so the
+//   positions do not belong to the same instant. RotEncoderGroup<PositionT, N> holds up to N encoders, of any type, and
+//   snapshot() reads all positions in one critical section. The critical section is N position reads, each a few cycles.
+//
+//   RotEncoderStepTime stores the time of the last step of an encoder, from the onStep() hook. If it is given to add(), the
+//   snapshot has the step time of the encoder, read in the same critical section. snapshot() returns the time of the
+//   snapshot, all times are RotEncoderClock::now32() ticks:
+//
+//   class Axis : public RotEncoderPinsT<2, 3, RotEncoderStdDecoder, Axis> {
+//   public:
+//     RotEncoderStepTime stepTime;
+//     void onStep(int8_t) { stepTime.step(); }                                                       // Hook called by intr()
+//   };
+//   Axis x;
+//   RotEncoderPinsT<4, 5> y;                                                                         // Without step times
+//   RotEncoderGroup<long, 2> axes;
+//
+//   void setup() { x.begin(); y.begin(); axes.add(x, &x.stepTime); axes.add(y); }
+//   void loop() {
+//     RotEncoderGroup<long, 2>::Sample s[2];
+//     uint32_t now = axes.snapshot(s);                                                               // s[0] is x, s[1] is y
+//   }
+
+class RotEncoderStepTime {                                                                              // Time of last step, set by onStep()
+public:
+  inline void step() __attribute__((always_inline)) { time = RotEncoderClock::now32(); }                // Interrupt handler: Store time of step
+  uint32_t get() const {                                                                                // Main loop: Returns time of last step, 0 if none
+    uint32_t t;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { t = time; }
+    return t;
+  }
+
+private:
+  template <class PositionT, uint8_t N> friend class RotEncoderGroup;                                   // Read in critical section of snapshot()
+  volatile uint32_t time = 0;                                                                           // RotEncoderClock::now32() of last step
+};
+
+template <class PositionT = long, uint8_t N = 4>
+class RotEncoderGroup {                                                                                 // Consistent snapshot of up to N encoders
+public:
+  struct Sample {                                                                                       // Snapshot of one encoder
+    PositionT position;                                                                                 //   Position
+    uint32_t stepTime;                                                                                  //   Time of last step, 0 without RotEncoderStepTime
+  };
+
+  template <class Encoder> bool add(const Encoder& e, const RotEncoderStepTime* t = nullptr);           // Add encoder, returns false if full
+  void clear() { count = 0; }                                                                           // Remove all encoders
+  uint8_t size() const { return count; }                                                                // Number of encoders, samples filled by snapshot()
+  uint32_t snapshot(Sample* out) const;                                                                 // Fills size() samples in order of add(), returns time of snapshot
+
+private:
+  typedef PositionT (*ReadT)(const void* enc);                                                          // Reads position of encoder type
+  template <class Encoder> static PositionT read(const void* enc) {                                     // Generated for each encoder type
+    return (PositionT)static_cast<const Encoder*>(enc)->getPosition();
+  }
+  struct Entry {
+    const void* enc;                                                                                    //   Encoder
+    ReadT rd;                                                                                           //   Reads position of encoder
+    const RotEncoderStepTime* time;                                                                     //   Step time, nullptr if none
+  };
+  Entry entries[N];
+  uint8_t count = 0;                                                                                    // Number of encoders
+};
+
+template <class PositionT, uint8_t N>
+template <class Encoder>
+bool RotEncoderGroup<PositionT, N>::add(const Encoder& e, const RotEncoderStepTime* t) {                // Add encoder, returns false if full
+  if (count >= N) return false;
+  entries[count].enc = &e;
+  entries[count].rd = &read<Encoder>;
+  entries[count].time = t;
+  count++;
+  return true;
+}
+
+template <class PositionT, uint8_t N>
+uint32_t RotEncoderGroup<PositionT, N>::snapshot(Sample* out) const {                                   // All positions at one instant
+  uint32_t now;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {                                                                   // No step between the reads
+    for (uint8_t i = 0; i < count; i++) {
+      out[i].position = entries[i].rd(entries[i].enc);                                                  // Lock-free read does not retry here
+      out[i].stepTime = entries[i].time ? entries[i].time->time : 0;
+    }
+    now = RotEncoderClock::now32();                                                                     // Time of snapshot, interrupts disabled
+  }
+  return now;
+}
+
+#endif  // ROTENCODERGROUP_H
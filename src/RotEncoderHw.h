@@ -0,0 +1,188 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderHw.h                                                                                                            //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERHW_H
+#define ROTENCODERHW_H
+
+#include <Arduino.h>
+
+// Hardware quadrature decoder backend for 32-bit targets:
+//
+//   RotEncoderHw<PinA, PinB, Steps> has the same begin(), end() and getPosition() as RotEncoder, but counts in a hardware
+//   quadrature counter, so there is no CPU load and no interrupts, also at high RPM. The hardware counts every edge, and
+//   Steps edges (default 4, one full cycle) are one position step, rounded so the position does not toggle when a detented
+//   encoder rests in a contact position. Direction is the same as RotEncoder, swap the A and B wires if it counts the wrong
+//   way. ROTENCODER_HW_DECODER is defined if a backend is available for the target:
+//
+//   ESP32:  PCNT (pulse counter) unit with glitch filter, using the ESP-IDF 5 pulse_cnt driver (arduino-esp32 3.x). Any
+//           GPIO can be used.
+//   STM32:  Timer in encoder mode with input filter (STM32duino). PinA must be channel 1 and PinB channel 2 of the same
+//           timer, begin() returns false otherwise. The 16-bit counter is extended to 32 bits in getPosition(), which must
+//           be called at least once per 8192 steps.
+//
+//   The pull-ups stay on while the encoder is counting, as the hardware must see every edge, so the dynamic pull-up power
+//   saving of RotEncoder is not available with this backend.
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(__has_include)
+  #if __has_include(<driver/pulse_cnt.h>)
+    #include <driver/pulse_cnt.h>
+    #define ROTENCODER_HW_DECODER                                                                       // ESP32 PCNT
+
+template <uint8_t PinA, uint8_t PinB, uint8_t Steps = 4>
+class RotEncoderHw {                                                                                    // Rotary encoder counted by ESP32 PCNT
+public:
+  inline uint8_t getPinA() const { return PinA; }
+  inline uint8_t getPinB() const { return PinB; }
+
+  bool begin() {                                                                                        // Start rotary encoder, returns true if successful
+    if (unit != nullptr) return false;                                                                  // Already started
+    pcnt_unit_config_t uc = {};                                                                         // Unit with 32-bit accumulated count
+    uc.low_limit = -32768; uc.high_limit = 32767;
+    uc.flags.accum_count = 1;                                                                           //   Extend 16-bit hardware counter at the limits
+    if (pcnt_new_unit(&uc, &unit) != ESP_OK) { unit = nullptr; return false; }                          // No free unit
+    pcnt_glitch_filter_config_t fc = {}; fc.max_glitch_ns = 1000;                                       // Ignore pulses shorter than 1 us
+    pcnt_unit_set_glitch_filter(unit, &fc);
+    pcnt_chan_config_t ca = {}; ca.edge_gpio_num = PinA; ca.level_gpio_num = PinB;                      // Channel A: Edges on A, direction from B
+    pcnt_chan_config_t cb = {}; cb.edge_gpio_num = PinB; cb.level_gpio_num = PinA;                      // Channel B: Edges on B, direction from A
+    pcnt_new_channel(unit, &ca, &chA);
+    pcnt_new_channel(unit, &cb, &chB);
+    pcnt_channel_set_edge_action(chA, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_DECREASE); // Count down when A leads
+    pcnt_channel_set_level_action(chA, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE);
+    pcnt_channel_set_edge_action(chB, PCNT_CHANNEL_EDGE_ACTION_DECREASE, PCNT_CHANNEL_EDGE_ACTION_INCREASE);
+    pcnt_channel_set_level_action(chB, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE);
+    pcnt_unit_add_watch_point(unit, uc.high_limit);                                                     // Watch points at limits are required for accum_count
+    pcnt_unit_add_watch_point(unit, uc.low_limit);
+    pinMode(PinA, INPUT_PULLUP);                                                                        // Pull-ups for open-drain/open-collector encoder
+    pinMode(PinB, INPUT_PULLUP);
+    pcnt_unit_enable(unit);
+    pcnt_unit_clear_count(unit);
+    pcnt_unit_start(unit);
+    return true;                                                                                        // Return true if ok
+  }
+
+  bool end() {                                                                                          // Stop rotary encoder, returns true if successful
+    if (unit == nullptr) return false;                                                                  // Not started
+    pcnt_unit_stop(unit);
+    pcnt_unit_disable(unit);
+    pcnt_del_channel(chA);
+    pcnt_del_channel(chB);
+    pcnt_del_unit(unit);
+    unit = nullptr;
+    return true;
+  }
+
+  long getPosition() const {                                                                            // Returns rotary encoder position
+    int count = 0;
+    if (unit != nullptr) pcnt_unit_get_count(unit, &count);                                             // Read accumulated count, no interrupts disabled
+    return toSteps(count);
+  }
+
+  ~RotEncoderHw() { end(); }
+
+private:
+  pcnt_unit_handle_t unit = nullptr;                                                                    // PCNT unit, nullptr if not started
+  pcnt_channel_handle_t chA = nullptr, chB = nullptr;                                                   // PCNT channels
+  static long toSteps(long count) { long c = count + Steps / 2; return (c >= 0) ? (c / Steps) : -((Steps - 1 - c) / Steps); } // Round to nearest step
+};
+
+  #endif
+
+#elif defined(ARDUINO_ARCH_STM32)
+  #include <HardwareTimer.h>
+  #define ROTENCODER_HW_DECODER                                                                         // STM32 timer encoder mode
+
+template <uint8_t PinA, uint8_t PinB, uint8_t Steps = 4>
+class RotEncoderHw {                                                                                    // Rotary encoder counted by STM32 timer in encoder mode
+public:
+  inline uint8_t getPinA() const { return PinA; }
+  inline uint8_t getPinB() const { return PinB; }
+
+  bool begin() {                                                                                        // Start rotary encoder, returns true if successful
+    if (htim.Instance != nullptr) return false;                                                         // Already started
+    PinName a = digitalPinToPinName(PinA);
+    PinName b = digitalPinToPinName(PinB);
+    TIM_TypeDef* tim = (TIM_TypeDef*)pinmap_peripheral(a, PinMap_TIM);
+    if ((tim == NP) || (tim != (TIM_TypeDef*)pinmap_peripheral(b, PinMap_TIM))) return false;           // Both pins must be on the same timer
+    if ((STM_PIN_CHANNEL(pinmap_function(a, PinMap_TIM)) != 1) || (STM_PIN_CHANNEL(pinmap_function(b, PinMap_TIM)) != 2)) return false; // PinA on CH1, PinB on CH2
+    pinmap_pinout(a, PinMap_TIM);                                                                       // Alternate function for timer input
+    pinmap_pinout(b, PinMap_TIM);
+    pin_PullConfig(get_GPIO_Port(STM_PORT(a)), STM_LL_GPIO_PIN(a), GPIO_PULLUP);                        // Pull-ups for open-drain/open-collector encoder
+    pin_PullConfig(get_GPIO_Port(STM_PORT(b)), STM_LL_GPIO_PIN(b), GPIO_PULLUP);
+
+    htim.Instance = tim;
+    htim.Init.Prescaler = 0;
+    htim.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim.Init.Period = 0xFFFF;                                                                          // Full 16-bit range, extended in getPosition()
+    htim.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    enableTimerClock(&htim);
+    TIM_Encoder_InitTypeDef enc = {};
+    enc.EncoderMode = TIM_ENCODERMODE_TI12;                                                             // Count all edges of both inputs
+    enc.IC1Polarity = TIM_ICPOLARITY_FALLING;                                                           // Invert TI1 for same direction as RotEncoder
+    enc.IC1Selection = TIM_ICSELECTION_DIRECTTI;
+    enc.IC1Prescaler = TIM_ICPSC_DIV1;
+    enc.IC1Filter = 0x0F;                                                                               // Max. input filter against contact bounce
+    enc.IC2Polarity = TIM_ICPOLARITY_RISING;
+    enc.IC2Selection = TIM_ICSELECTION_DIRECTTI;
+    enc.IC2Prescaler = TIM_ICPSC_DIV1;
+    enc.IC2Filter = 0x0F;
+    if ((HAL_TIM_Encoder_Init(&htim, &enc) != HAL_OK) || (HAL_TIM_Encoder_Start(&htim, TIM_CHANNEL_ALL) != HAL_OK)) {
+      htim.Instance = nullptr;
+      return false;
+    }
+    last = 0; count = 0;
+    __HAL_TIM_SET_COUNTER(&htim, 0);
+    return true;                                                                                        // Return true if ok
+  }
+
+  bool end() {                                                                                          // Stop rotary encoder, returns true if successful
+    if (htim.Instance == nullptr) return false;                                                         // Not started
+    HAL_TIM_Encoder_Stop(&htim, TIM_CHANNEL_ALL);
+    HAL_TIM_Encoder_DeInit(&htim);
+    htim.Instance = nullptr;
+    return true;
+  }
+
+  long getPosition() const {                                                                            // Returns rotary encoder position
+    if (htim.Instance == nullptr) return toSteps(count);
+    uint16_t c = __HAL_TIM_GET_COUNTER(&htim);                                                          // Read hardware counter, no interrupts disabled
+    count += (int16_t)(c - last);                                                                       // Extend to 32 bits by signed 16-bit difference
+    last = c;
+    return toSteps(count);
+  }
+
+  ~RotEncoderHw() { end(); }
+
+private:
+  TIM_HandleTypeDef htim = {};                                                                          // Timer handle, Instance is nullptr if not started
+  mutable uint16_t last = 0;                                                                            // Last hardware count
+  mutable long count = 0;                                                                               // Extended count
+  static long toSteps(long count) { long c = count + Steps / 2; return (c >= 0) ? (c / Steps) : -((Steps - 1 - c) / Steps); } // Round to nearest step
+};
+
+#endif
+
+#endif  // ROTENCODERHW_H
@@ -0,0 +1,101 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderIO.h                                                                                                            //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERIO_H
+#define ROTENCODERIO_H
+
+#include <Arduino.h>
+
+// Direct port I/O for pins known at compile time:
+//
+//   digitalRead(), digitalWrite() and pinMode() look up port and bitmask in tables for every call. RotEncoderPortIO<Pin>
+//   resolves the PINx, DDRx and PORTx registers and the bitmask at compile time, so each function is a single sbic, sbi or
+//   cbi instruction. Only defined for MCUs with a known pin mapping, ROTENCODER_DIRECT_IO is defined if available.
+//
+//   On AVR the registers for each port are placed in order PINx, DDRx, PORTx in I/O space. RotEncoderPinMap gives the PINx
+//   address and the bit of each Arduino pin, for the ATmega328P family and for ATtiny25/45/85.
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168P__) || defined(__AVR_ATmega168__) || \
+    defined(__AVR_ATmega88P__)  || defined(__AVR_ATmega88__)  || defined(__AVR_ATmega48P__)  || defined(__AVR_ATmega48__)
+  #define ROTENCODER_DIRECT_IO                                                                          // Arduino Uno, Nano, Pro Mini: D0-D7 = PORTD, D8-D13 = PORTB, A0-A5 = PORTC
+
+struct RotEncoderPinMap {                                                                               // Port and bit of each Arduino pin
+  static constexpr uint8_t pins = 20;                                                                   // A6 and A7 are analog only
+  static constexpr uint8_t pinReg(uint8_t p) { return (p < 8) ? 0x09 : ((p < 14) ? 0x03 : 0x06); }      // I/O address of PIND, PINB or PINC
+  static constexpr uint8_t bit(uint8_t p) { return (p < 8) ? p : ((p < 14) ? (p - 8) : (p - 14)); }     // Bit of pin in port
+};
+
+enum RotEncoderPort : uint8_t {                                                                         // Port by its first Arduino pin, for RotEncoderBank
+  RotEncoderPortD = 0,                                                                                  //   D0-D7
+  RotEncoderPortB = 8,                                                                                  //   D8-D13
+  RotEncoderPortC = 14                                                                                  //   A0-A5
+};
+
+#elif defined(__AVR_ATtiny85__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny25__)
+  #define ROTENCODER_DIRECT_IO                                                                          // ATtiny25/45/85: Pin 0-5 = PB0-PB5, as in ATTinyCore and the attiny core
+
+struct RotEncoderPinMap {                                                                               // Port and bit of each Arduino pin
+  static constexpr uint8_t pins = 6;                                                                    // PB5 is RESET unless the RSTDISBL fuse is set
+  static constexpr uint8_t pinReg(uint8_t) { return 0x16; }                                             // I/O address of PINB
+  static constexpr uint8_t bit(uint8_t p) { return p; }                                                 // Bit of pin in PORTB
+};
+
+#endif
+
+#ifdef ROTENCODER_DIRECT_IO
+
+template <uint8_t Pin>
+struct RotEncoderPortIO {                                                                               // Direct port I/O for one pin
+  static_assert(Pin < RotEncoderPinMap::pins, "RotEncoderPortIO: Pin has no digital I/O");
+
+  static constexpr uint8_t pinReg = RotEncoderPinMap::pinReg(Pin);                                      // I/O address of PINx
+  static constexpr uint8_t ddrReg = pinReg + 1;                                                         // I/O address of DDRx
+  static constexpr uint8_t portReg = pinReg + 2;                                                        // I/O address of PORTx
+  static constexpr uint8_t mask = 1 << RotEncoderPinMap::bit(Pin);                                      // Bitmask for pin in port
+
+  static inline bool rd() __attribute__((always_inline)) { return !(_SFR_IO8(pinReg) & mask); }         // Reads pin (high when switch closed, low open)
+  static inline void en() __attribute__((always_inline)) { _SFR_IO8(ddrReg) &= ~mask; _SFR_IO8(portReg) |= mask; } // Set to input and activate pull-up
+  static inline void di() __attribute__((always_inline)) { _SFR_IO8(portReg) &= ~mask; _SFR_IO8(ddrReg) |= mask; } // Set output low and deactivate pull-up
+};
+
+template <uint8_t PinA, uint8_t PinB>
+struct RotEncoderPortPair {                                                                             // Direct port I/O for both encoder pins
+  typedef RotEncoderPortIO<PinA> A;
+  typedef RotEncoderPortIO<PinB> B;
+
+  static inline uint8_t rd() __attribute__((always_inline)) {                                           // Reads pins, bit 1 = PinA, bit 0 = PinB (high when closed)
+    if (A::pinReg == B::pinReg) {                                                                       // Same port, resolved at compile time:
+      uint8_t v = _SFR_IO8(A::pinReg);                                                                  // Both pins in one port read
+      return ((v & A::mask) ? 0 : 2) | ((v & B::mask) ? 0 : 1);
+    }
+    return (A::rd() ? 2 : 0) | (B::rd() ? 1 : 0);                                                       // Different ports, one read each
+  }
+};
+
+#endif
+
+#endif  // ROTENCODERIO_H
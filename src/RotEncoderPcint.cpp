@@ -0,0 +1,134 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderPcint.cpp                                                                                                       //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "RotEncoder.h"
+
+#ifdef ROTENCODER_PCINT
+
+RotEncoderPcint::Group RotEncoderPcint::groups[ROTENCODER_PCINT_GROUPS] = {};                           // No pins attached
+
+#if defined(PCICR)
+  #define ROTENCODER_PCICR PCICR                                                                        // ATmega: PCIEn in PCICR enables vector n
+  #define ROTENCODER_PCIE(g) _BV(g)
+#else
+  #define ROTENCODER_PCICR GIMSK                                                                        // ATtiny25/45/85: PCIE in GIMSK enables the only vector
+  #define ROTENCODER_PCIE(g) _BV(PCIE)
+#endif
+
+
+void RotEncoderPcint::enable() {                                                                        // Let begin() use pin change interrupts, links the vectors below
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    attachFn = &doAttach;
+    detachFn = &doDetach;
+  }
+}
+
+bool RotEncoderPcint::doAttach(uint8_t pin, void* handle, CallT call) {                                 // Attach pin to its pin change vector
+#if defined(PCICR)
+  if (digitalPinToPCICR(pin) == nullptr) return false;                                                  // Pin has no pin change interrupt
+  uint8_t g = digitalPinToPCICRbit(pin);
+  if (g >= ROTENCODER_PCINT_GROUPS) return false;
+  volatile uint8_t* pcmsk = digitalPinToPCMSK(pin);
+  uint8_t pcbit = digitalPinToPCMSKbit(pin);
+#else
+  if (pin >= RotEncoderPinMap::pins) return false;                                                      // ATtiny25/45/85: PCINTn is PBn, pin n
+  uint8_t g = 0;
+  volatile uint8_t* pcmsk = &PCMSK;
+  uint8_t pcbit = pin;
+#endif
+  const volatile uint8_t* reg = portInputRegister(digitalPinToPort(pin));
+  uint8_t mask = digitalPinToBitMask(pin);
+  uint8_t i = 0;
+  while ((mask >> i) > 1) i++;                                                                          // Slot index is bit number in port
+  bool ok = false;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {                                                                   // Test and set must be atomic
+    Group& gr = groups[g];
+    if (((gr.pin == nullptr) || (gr.pin == reg)) && (gr.slot[i].handle == nullptr)) {                   // Group on one port only (not ATmega2560 PCINT1), pin not used
+      if (gr.pin == nullptr) {                                                                          //   First pin in group
+        gr.pin = reg;
+        gr.pcmsk = pcmsk;
+        gr.last = *reg;
+      }
+      gr.slot[i].call = call;
+      gr.slot[i].pcmsk = _BV(pcbit);
+      gr.slot[i].handle = handle;
+      *gr.pcmsk |= gr.slot[i].pcmsk;                                                                    //   Enable pin and vector
+      ROTENCODER_PCICR |= ROTENCODER_PCIE(g);
+      ok = true;
+    }
+  }
+  return ok;
+}
+
+void RotEncoderPcint::doDetach(const void* handle) {                                                    // Detach all pins of handle
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    for (uint8_t g = 0; g < ROTENCODER_PCINT_GROUPS; g++) {
+      Group& gr = groups[g];
+      if (gr.pin == nullptr) continue;
+      for (uint8_t i = 0; i < 8; i++) {
+        if (gr.slot[i].handle != handle) continue;
+        *gr.pcmsk &= ~gr.slot[i].pcmsk;                                                                 // Disable pin before handle is removed
+        gr.slot[i].handle = nullptr;
+      }
+      if (*gr.pcmsk == 0) {                                                                             // Last pin in group, disable vector
+        ROTENCODER_PCICR &= ~ROTENCODER_PCIE(g);
+        gr.pin = nullptr;
+      }
+    }
+  }
+}
+
+inline void RotEncoderPcint::dispatch(uint8_t g) {                                                      // One port read, calls intr() for changed pins only
+  Group& gr = groups[g];
+  const volatile uint8_t* reg = gr.pin;
+  if (reg == nullptr) return;
+  uint8_t v = *reg;                                                                                     // Single read of port
+  uint8_t c = v ^ gr.last;                                                                              // Changed pins
+  gr.last = v;
+  void* done = nullptr;                                                                                 // Last instance called
+  for (uint8_t i = 0; c != 0; i++, c >>= 1) {                                                           // Stops after highest changed pin
+    if (!(c & 1)) continue;
+    void* h = gr.slot[i].handle;                                                                        // Read handle once
+    if ((h != nullptr) && (h != done)) gr.slot[i].call(h);                                              // Call intr() in instance type, once if both pins changed
+    done = h;
+  }
+}
+
+#if defined(PCINT0_vect)
+ISR(PCINT0_vect) { RotEncoderPcint::dispatch(0); }                                                      // Pin change vectors, linked only if enable() is used
+#endif
+#if defined(PCINT1_vect)
+ISR(PCINT1_vect) { RotEncoderPcint::dispatch(1); }
+#endif
+#if defined(PCINT2_vect)
+ISR(PCINT2_vect) { RotEncoderPcint::dispatch(2); }
+#endif
+#if defined(PCINT3_vect) && (ROTENCODER_PCINT_GROUPS > 3)
+ISR(PCINT3_vect) { RotEncoderPcint::dispatch(3); }
+#endif
+
+#endif  // ROTENCODER_PCINT
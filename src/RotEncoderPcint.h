@@ -0,0 +1,100 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderPcint.h                                                                                                         //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERPCINT_H
+#define ROTENCODERPCINT_H
+
+#include <Arduino.h>
+
+// Pin change interrupts (PCINT) on AVR, for pins without an external interrupt:
+//
+//   AVR has one pin change vector per group of pins (PCINT0..PCINT2 on ATmega328P, one per port, PCINT0 for PB0-PB5 on
+//   ATtiny25/45/85). After
+//   RotEncoderPcint::enable() is called, begin() of all interrupt driven encoders uses the pin change vector for a pin that
+//   has no external interrupt. The vector handler reads the port once, XORs it with the last read, and calls intr() only
+//   for the encoders with a pin that changed. Up to 8 encoder pins can share one vector.
+//   A pull-up turned on by intr() changes the pin again and sets the pin change flag, so the vector runs once more and the
+//   last read stays in step with the port.
+//
+//   The pin change vectors are only linked into the sketch if enable() is called, so other libraries using them (e.g.
+//   SoftwareSerial) can be used as long as enable() is not called.
+//
+//   void setup() {
+//     RotEncoderPcint::enable();                                                                     // Before begin()
+//     encoder.begin();
+//   }
+
+#if defined(PCICR) && defined(digitalPinToPCICR)                                                        // Pin change interrupts available
+  #define ROTENCODER_PCINT
+#elif defined(GIMSK) && defined(PCIE) && defined(PCMSK) && defined(ROTENCODER_DIRECT_IO)                // ATtiny25/45/85: One vector, PCIE in GIMSK
+  #define ROTENCODER_PCINT
+  #define ROTENCODER_PCINT_GROUPS 1
+#endif
+
+#define ROTENCODER_PIN_CHANGE -2                                                                        // Interrupt number used by RotEncoderT for a pin change interrupt
+
+#ifdef ROTENCODER_PCINT
+
+#ifndef ROTENCODER_PCINT_GROUPS                                                                         // Number of pin change vectors
+  #if defined(PCINT3_vect)
+    #define ROTENCODER_PCINT_GROUPS 4
+  #else
+    #define ROTENCODER_PCINT_GROUPS 3
+  #endif
+#endif
+
+class RotEncoderPcint {                                                                                 // Pin change interrupt dispatcher
+public:
+  typedef void (*CallT)(void* handle);                                                                  // Function that calls intr() in handle
+  static void enable();                                                                                 // Let begin() use pin change interrupts, call before begin()
+  static bool attach(uint8_t pin, void* handle, CallT call) { return (attachFn != nullptr) && attachFn(pin, handle, call); } // Attach pin, returns true if successful
+  static void detach(const void* handle) { if (detachFn != nullptr) detachFn(handle); }                 // Detach all pins of handle
+  static void dispatch(uint8_t g);                                                                      // Called from pin change vector of group g
+
+private:
+  static bool (*attachFn)(uint8_t pin, void* handle, CallT call);                                       // Set by enable(), nullptr if not enabled
+  static void (*detachFn)(const void* handle);
+  static bool doAttach(uint8_t pin, void* handle, CallT call);                                          // Implementation, linked only if enable() is used
+  static void doDetach(const void* handle);
+
+  struct Slot {                                                                                         // Encoder pin, indexed by bit in port
+    void* volatile handle;                                                                              //   Encoder instance, nullptr if unused
+    CallT call;                                                                                         //   Calls intr() in instance type
+    uint8_t pcmsk;                                                                                      //   Bitmask in PCMSKn
+  };
+  struct Group {                                                                                        // Pin change vector
+    const volatile uint8_t* pin;                                                                        //   Input register of port, nullptr if no pins attached
+    volatile uint8_t* pcmsk;                                                                            //   Pin change mask register
+    uint8_t last;                                                                                       //   Last read of input register
+    Slot slot[8];
+  };
+  static Group groups[ROTENCODER_PCINT_GROUPS];
+};
+
+#endif  // ROTENCODER_PCINT
+
+#endif  // ROTENCODERPCINT_H
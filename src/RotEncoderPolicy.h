@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderPolicy.h                                                                                                        //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERPOLICY_H
+#define ROTENCODERPOLICY_H
+
+#include <Arduino.h>
+
+// Encoder configured by policies (included by RotEncoder.h):
+//
+//   RotEncoderPolicyT<IO, Decoder, Counter, Power> builds the encoder from four policies, each resolved at compile time.
+//   A feature that is not selected is not compiled at all. There is no vtable and no virtual destructor:
+//
+//   - IO: Reads the pins and switches the pull-ups. RotEncoderPortPinIO<PinA, PinB> uses direct port I/O, so digitalRead(),
+//     digitalWrite() and pinMode() and their pin tables are not linked. It is only defined if the pin mapping is known
+//     (ROTENCODER_DIRECT_IO, ATmega328P family and ATtiny25/45/85, see RotEncoderPinMap in RotEncoderIO.h).
+//     RotEncoderArduinoIO<PinA, PinB> always uses the Arduino functions, and RotEncoderPinIO<PinA, PinB> selects direct
+//     port I/O if available, else the Arduino functions. Own I/O policies have the same static functions.
+//   - Decoder: The state machine, see RotEncoderDecoder.h.
+//   - Counter: Type and overflow policy of the position, see RotEncoderCounter.h. A counter that fits in one load has no
+//     sequence counter.
+//   - Power: RotEncoderPowerSave turns the pull-up of a closed switch off, as all other encoders of this library.
+//     RotEncoderPowerOn leaves the pull-ups on, for the shortest interrupt handler at the cost of the pull-up current.
+//
+//   RotEncoderPolicyT<RotEncoderPinIO<2, 3>, RotEncoderStdDecoder, RotEncoderCounterT<int8_t>, RotEncoderPowerSave> knob;
+//
+//   RotEncoderDirectPins<PinA, PinB> is direct port I/O, RotEncoderStdDecoder, an int8_t counter read by readAndResetDelta()
+//   and the power saving. Like RotEncoderPortPinIO it is only defined with ROTENCODER_DIRECT_IO, so it never falls back to
+//   the Arduino functions. On ATtiny25/45/85 only pin 2 has an external interrupt (INT0), the other pin uses the pin change
+//   vector after RotEncoderPcint::enable(). No size table is given: The sizes have not been measured on a board or with
+//   avr-gcc yet. The flash used depends on core and compiler, measure it with avr-size.
+//   Derived can be set to an own class to override hooks, as for RotEncoderPinsT.
+
+template <uint8_t PinA, uint8_t PinB>
+struct RotEncoderArduinoIO {                                                                            // I/O policy with the Arduino functions
+  static constexpr uint8_t pinA = PinA;                                                                 // Pins, for the interrupt numbers
+  static constexpr uint8_t pinB = PinB;
+  static inline bool rdA() __attribute__((always_inline)) { return !digitalRead(PinA); }                // Reads pinA (high when switch closed)
+  static inline bool rdB() __attribute__((always_inline)) { return !digitalRead(PinB); }                // Reads pinB (high when switch closed)
+  static inline uint8_t rd() __attribute__((always_inline)) { return (rdA() ? 2 : 0) | (rdB() ? 1 : 0); } // Reads both pins, bit 1 = PinA, bit 0 = PinB
+  static inline void enA() __attribute__((always_inline)) { pinMode(PinA, INPUT_PULLUP); }              // Input with pull-up
+  static inline void enB() __attribute__((always_inline)) { pinMode(PinB, INPUT_PULLUP); }
+  static inline void diA() __attribute__((always_inline)) { digitalWrite(PinA, LOW); pinMode(PinA, OUTPUT); } // Output low, pull-up off
+  static inline void diB() __attribute__((always_inline)) { digitalWrite(PinB, LOW); pinMode(PinB, OUTPUT); }
+};
+
+#ifdef ROTENCODER_DIRECT_IO
+template <uint8_t PinA, uint8_t PinB>
+struct RotEncoderPortPinIO {                                                                            // I/O policy with direct port I/O
+  static constexpr uint8_t pinA = PinA;                                                                 // Pins, for the interrupt numbers
+  static constexpr uint8_t pinB = PinB;
+  static inline bool rdA() __attribute__((always_inline)) { return RotEncoderPortIO<PinA>::rd(); }      // Reads pinA by single port read
+  static inline bool rdB() __attribute__((always_inline)) { return RotEncoderPortIO<PinB>::rd(); }      // Reads pinB by single port read
+  static inline uint8_t rd() __attribute__((always_inline)) { return RotEncoderPortPair<PinA, PinB>::rd(); } // Reads both pins, one port read if same port
+  static inline void enA() __attribute__((always_inline)) { RotEncoderPortIO<PinA>::en(); }             // Input with pull-up
+  static inline void enB() __attribute__((always_inline)) { RotEncoderPortIO<PinB>::en(); }
+  static inline void diA() __attribute__((always_inline)) { RotEncoderPortIO<PinA>::di(); }             // Output low, pull-up off
+  static inline void diB() __attribute__((always_inline)) { RotEncoderPortIO<PinB>::di(); }
+};
+
+template <uint8_t PinA, uint8_t PinB>
+struct RotEncoderPinIO : RotEncoderPortPinIO<PinA, PinB> { };                                           // Direct port I/O if available
+#else
+template <uint8_t PinA, uint8_t PinB>
+struct RotEncoderPinIO : RotEncoderArduinoIO<PinA, PinB> { };                                           // No known pin mapping, Arduino functions
+#endif
+
+struct RotEncoderPowerSave {                                                                            // Power policy: Pull-up off for closed switch
+  static constexpr bool pullUpOff = true;
+};
+
+struct RotEncoderPowerOn {                                                                              // Power policy: Pull-ups always on
+  static constexpr bool pullUpOff = false;
+};
+
+template <class IO, class Decoder = RotEncoderStdDecoder, class Counter = RotEncoderCounter, class Power = RotEncoderPowerSave, class Derived = void>
+class RotEncoderPolicyT : public RotEncoderT<typename RotEncoderDerived<Derived, RotEncoderPolicyT<IO, Decoder, Counter, Power, Derived> >::type, Decoder, Counter> {
+  typedef RotEncoderT<typename RotEncoderDerived<Derived, RotEncoderPolicyT>::type, Decoder, Counter> Core; // CRTP core
+public:
+  inline uint8_t getPinA() const __attribute__((always_inline)) { return IO::pinA; }                    // Pins of the I/O policy
+  inline uint8_t getPinB() const __attribute__((always_inline)) { return IO::pinB; }
+
+protected:
+  friend Core;                                                                                          // Core calls the I/O functions below
+  inline bool rdPinA() __attribute__((always_inline)) { return IO::rdA(); }                             // Reads pinA
+  inline bool rdPinB() __attribute__((always_inline)) { return IO::rdB(); }                             // Reads pinB
+  inline uint8_t rdPins() __attribute__((always_inline)) { return IO::rd(); }                           // Reads both pins
+  inline void enPinA() __attribute__((always_inline)) { if (Power::pullUpOff) IO::enA(); }              // Pull-up on again after di, not needed if never off
+  inline void enPinB() __attribute__((always_inline)) { if (Power::pullUpOff) IO::enB(); }
+  inline void diPinA() __attribute__((always_inline)) { if (Power::pullUpOff) IO::diA(); }              // Pull-up off for closed switch, resolved at compile time
+  inline void diPinB() __attribute__((always_inline)) { if (Power::pullUpOff) IO::diB(); }
+
+public:
+  bool begin() {                                                                                        // Start rotary encoder, returns true if successful
+    if (!Power::pullUpOff) { IO::enA(); IO::enB(); }                                                    // Pull-ups on once, Core::begin() calls enPinA() and enPinB()
+    return Core::begin();
+  }
+};
+
+#ifdef ROTENCODER_DIRECT_IO
+template <uint8_t PinA = 2, uint8_t PinB = 3>                                                           // Direct port I/O, int8_t counter, power saving
+using RotEncoderDirectPins = RotEncoderPolicyT<RotEncoderPortPinIO<PinA, PinB>, RotEncoderStdDecoder, RotEncoderCounterT<int8_t>, RotEncoderPowerSave>;
+#endif
+
+#endif  // ROTENCODERPOLICY_H
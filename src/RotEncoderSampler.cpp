@@ -0,0 +1,301 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderSampler.cpp                                                                                                     //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "RotEncoderSampler.h"
+#include "RotEncoderAtomic.h"
+
+RotEncoderSampled* RotEncoderSampler::list[ROTENCODER_MAX_SAMPLED] = {};                                // No encoders registered
+volatile uint8_t RotEncoderSampler::count = 0;
+uint16_t RotEncoderSampler::rate = ROTENCODER_SAMPLE_HZ;
+uint16_t RotEncoderSampler::slowRate = 0;                                                               // Low power off
+uint8_t RotEncoderSampler::csFast = 0, RotEncoderSampler::csSlow = 0, RotEncoderSampler::cs = 0;
+uint8_t RotEncoderSampler::idle = 0;
+uint8_t RotEncoderSampler::wdt = 0xFF;                                                                  // No watchdog
+volatile bool RotEncoderSampler::onWatchdog = false;
+
+
+bool RotEncoderSampled::begin(uint8_t pinA, uint8_t pinB) {                                             // Start rotary encoder, returns true if successful
+  if (regA != nullptr) return false;                                                                    // Already started
+  if ((digitalPinToPort(pinA) == NOT_A_PIN) || (digitalPinToPort(pinB) == NOT_A_PIN)) return false;     // Not digital pins
+  pinMode(pinA, INPUT_PULLUP);                                                                          // Inputs with pull-up, always on when sampled
+  pinMode(pinB, INPUT_PULLUP);
+  maskA = digitalPinToBitMask(pinA);                                                                    // Resolve registers and bitmasks once
+  maskB = digitalPinToBitMask(pinB);
+  regA = (const volatile RotEncoderPortT*)portInputRegister(digitalPinToPort(pinA));
+  regB = (const volatile RotEncoderPortT*)portInputRegister(digitalPinToPort(pinB));
+  if (!RotEncoderSampler::add(this)) {                                                                  // Sampler full
+    regA = nullptr;
+    return false;
+  }
+  return true;                                                                                          // Return true if ok
+}
+
+bool RotEncoderSampled::end() {                                                                         // Stop rotary encoder, returns true if successful
+  if (regA == nullptr) return false;                                                                    // Return false if not started
+  RotEncoderSampler::remove(this);
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { RotEncoderSampler::pullUp(this, true); }                          // Leave pins as inputs with pull-up, also after low power
+  regA = nullptr;
+  return true;                                                                                          // Return true if ok
+}
+
+
+bool RotEncoderSampler::add(RotEncoderSampled* e) {                                                     // Register encoder, sorted by port so tick() reads each port once
+  bool ok = false;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {                                                                   // List is used by timer interrupt
+    uint8_t n = count;
+    if (n < ROTENCODER_MAX_SAMPLED) {
+      uint8_t i = n;
+      while ((i > 0) && (list[i - 1]->regA > e->regA)) { list[i] = list[i - 1]; i--; }                  // Insert sorted by port of PinA
+      list[i] = e;
+      count = n + 1;
+      ok = true;
+    }
+  }
+  if (ok && (count == 1)) startTimer();                                                                 // First encoder starts timer
+  return ok;
+}
+
+bool RotEncoderSampler::remove(RotEncoderSampled* e) {                                                  // Unregister encoder
+  bool ok = false;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    uint8_t n = count;
+    for (uint8_t i = 0; i < n; i++) {
+      if (list[i] == e) {
+        for (; i + 1 < n; i++) list[i] = list[i + 1];                                                   // Keep list sorted
+        count = n - 1;
+        ok = true;
+        break;
+      }
+    }
+  }
+  if (ok && (count == 0)) stopTimer();                                                                  // Last encoder stops timer
+  return ok;
+}
+
+bool RotEncoderSampler::tick() {                                                                        // Sample and decode all encoders, bounded time
+  const volatile RotEncoderPortT* reg = nullptr;                                                        // Port register read last
+  RotEncoderPortT v = 0;                                                                                // Value read from reg
+  uint8_t n = count;
+  bool moved = false;
+  if (slowRate) {                                                                                       // Low power: Pull-ups on, and wait for the pins to rise
+    pullUps(true);
+    delayMicroseconds(ROTENCODER_SETTLE_US);
+  }
+  for (uint8_t i = 0; i < n; i++) {
+    RotEncoderSampled* e = list[i];
+    if (e->regA != reg) { reg = e->regA; v = *reg; }                                                    // Read port only if not read already
+    uint8_t pins = (v & e->maskA) ? 0 : RotEncoderDecoder::PinA;                                        // Pins high when switch closed
+    if (e->regB != reg) { reg = e->regB; v = *reg; }
+    pins |= (v & e->maskB) ? 0 : RotEncoderDecoder::PinB;
+    uint8_t r = e->decoder.next(pins);                                                                  // Pull-up flags are ignored, pull-ups stay on
+    if (r & RotEncoderDecoder::Up) e->counter.add(1);
+    if (r & RotEncoderDecoder::Dn) e->counter.add(-1);
+    if (pins != e->pins) { e->pins = pins; moved = true; }                                              // Pin changed since last sample
+  }
+  if (slowRate) {                                                                                       // Low power:
+    pullUps(false);                                                                                     //   Pins driven low until next sample
+    adapt(moved);                                                                                       //   Sample faster or slower
+  }
+  return moved;
+}
+
+void RotEncoderSampler::pullUps(bool on) {                                                              // Pull-ups of all encoders on, or pins driven low
+  uint8_t n = count;
+  for (uint8_t i = 0; i < n; i++) pullUp(list[i], on);
+}
+
+
+#if defined(__AVR__) && defined(TCCR2A) && defined(OCR2A) && defined(TIMSK2)
+
+#include <avr/sleep.h>
+#if defined(WDTCSR) && defined(WDIE)
+  #include <avr/wdt.h>
+  #define ROTENCODER_SAMPLE_WDT                                                                         // Watchdog interrupt for rates below Timer2
+#endif
+
+static const uint16_t prescale[] = { 1, 8, 32, 64, 128, 256, 1024 };                                    // Timer2 prescalers, CS22:0 = 1..7
+static const uint8_t noWatchdog = 0xFF;                                                                 // Slow rate reached by Timer2
+static const uint8_t badRate = 0xFE;                                                                    // Slow rate not possible
+
+static uint16_t timerTop(uint16_t hz, uint8_t* cs) {                                                    // Timer2 top and prescaler (1..7) for hz
+  uint8_t c = 0;
+  uint32_t top;
+  do {
+    top = F_CPU / prescale[c] / hz;                                                                     // Find smallest prescaler where top fits in 8 bits
+    c++;
+  } while ((top > 256) && (c < 7));
+  *cs = c;
+  return top;
+}
+
+static uint8_t slowMode(uint16_t hz, uint16_t slowHz) {                                                 // Watchdog prescaler for slowHz, noWatchdog or badRate
+  if (slowHz == 0) return noWatchdog;                                                                   // Low power off
+  if (slowHz > hz) return badRate;                                                                      // Slow rate must be below rate
+  uint8_t c;
+  if (F_CPU / 1024 / timerTop(hz, &c) <= slowHz) return noWatchdog;                                     // Slowest Timer2 rate with the top of hz reaches slowHz
+#ifdef ROTENCODER_SAMPLE_WDT
+  if ((uint32_t)slowHz * 16 > 1000) return badRate;                                                     // Above the fastest watchdog rate, 16 ms
+  uint8_t k = 0;                                                                                        // Largest watchdog prescaler with rate >= slowHz
+#ifdef WDP3
+  const uint8_t kMax = 9;                                                                               //   Up to 8 s
+#else
+  const uint8_t kMax = 7;                                                                               //   Up to 2 s
+#endif
+  while ((k < kMax) && ((uint32_t)slowHz * (16UL << (k + 1)) <= 1000)) k++;
+  return k;
+#else
+  return badRate;                                                                                       // No watchdog interrupt
+#endif
+}
+
+bool RotEncoderSampler::setRate(uint16_t hz) {                                                          // Set sample rate, used by next start of timer
+  if ((hz == 0) || (F_CPU / 1024 / hz > 256)) return false;                                             // Too slow for Timer2
+  uint8_t w = slowMode(hz, slowRate);
+  if (w == badRate) return false;                                                                       // Slow rate of setLowPower() not possible with hz
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { rate = hz; wdt = w; }
+  if (count > 0) startTimer();                                                                          // Restart with new rate
+  return true;
+}
+
+bool RotEncoderSampler::setLowPower(uint16_t slowHz) {                                                  // Duty cycled pull-ups and adaptive rate, used by next start of timer
+  uint8_t w = slowMode(rate, slowHz);
+  if (w == badRate) return false;                                                                       // Not possible, see RotEncoderSampler.h
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    slowRate = slowHz;
+    wdt = w;
+    if (slowHz == 0) pullUps(true);                                                                     // Off: Pull-ups always on again
+  }
+  if (count > 0) startTimer();                                                                          // Restart with new prescalers
+  return true;
+}
+
+void RotEncoderSampler::startTimer() {                                                                  // Timer2 in CTC mode, compare interrupt at rate
+  uint8_t c;
+  uint16_t top = timerTop(rate, &c);
+  uint8_t s = c;                                                                                        // Low power: Largest prescaler with rate >= slowRate
+  while (slowRate && (s < 7) && (F_CPU / prescale[s] / top >= slowRate)) s++;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (onWatchdog) watchdog(false);                                                                    // Timer2 samples again
+    csFast = cs = c;
+    csSlow = s;
+    idle = 0;
+    TCCR2A = _BV(WGM21);                                                                                // CTC mode, top = OCR2A
+    TCCR2B = c;                                                                                         // Prescaler
+    OCR2A = top - 1;
+    TCNT2 = 0;
+    TIMSK2 |= _BV(OCIE2A);                                                                              // Enable compare interrupt
+  }
+}
+
+void RotEncoderSampler::stopTimer() {                                                                   // Stop Timer2 compare interrupt
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (onWatchdog) watchdog(false);
+    TIMSK2 &= ~_BV(OCIE2A);
+    TCCR2B = 0;                                                                                         // Stop timer
+  }
+}
+
+void RotEncoderSampler::pullUp(RotEncoderSampled* e, bool on) {                                         // Pull-ups of encoder on, or pins driven low
+  volatile uint8_t* a = (volatile uint8_t*)e->regA;                                                     // PINx, followed by DDRx and PORTx in I/O space
+  volatile uint8_t* b = (volatile uint8_t*)e->regB;
+  if (on) {
+    a[1] &= ~e->maskA; a[2] |= e->maskA;                                                                // Input with pull-up
+    b[1] &= ~e->maskB; b[2] |= e->maskB;
+  } else {
+    a[2] &= ~e->maskA; a[1] |= e->maskA;                                                                // Output low, no current
+    b[2] &= ~e->maskB; b[1] |= e->maskB;
+  }
+}
+
+void RotEncoderSampler::adapt(bool moved) {                                                             // Adapt the sample rate, called from timer interrupt
+  if (moved) {                                                                                          // Moving: Back to full rate
+    idle = 0;
+    if (onWatchdog) {                                                                                   //   From watchdog: Timer2 restarts at full rate
+      watchdog(false);
+      TCNT2 = 0;
+      TCCR2B = cs = csFast;
+      TIMSK2 |= _BV(OCIE2A);
+    } else if (cs != csFast) TCCR2B = cs = csFast;
+  } else if (!onWatchdog && (++idle >= ROTENCODER_IDLE_SAMPLES)) {                                      // Idle: One step slower
+    idle = 0;
+    if (cs < csSlow) TCCR2B = ++cs;                                                                     //   Next Timer2 prescaler
+    else if (wdt != noWatchdog) {                                                                       //   Slowest Timer2 rate: Watchdog samples, Timer2 stopped
+      TIMSK2 &= ~_BV(OCIE2A);
+      TCCR2B = 0;
+      watchdog(true);
+    }
+  }
+}
+
+#ifdef ROTENCODER_SAMPLE_WDT
+
+void RotEncoderSampler::watchdog(bool on) {                                                             // Watchdog interrupt every 16 ms * 2^wdt, or off, interrupts disabled
+  wdt_reset();
+  WDTCSR = _BV(WDCE) | _BV(WDE);                                                                        // Timed sequence, next write within 4 cycles
+#ifdef WDP3
+  WDTCSR = on ? (_BV(WDIE) | (wdt & 7) | ((wdt & 8) ? _BV(WDP3) : 0)) : 0;                              // Interrupt only, no reset
+#else
+  WDTCSR = on ? (_BV(WDIE) | (wdt & 7)) : 0;
+#endif
+  onWatchdog = on;
+}
+
+ISR(WDT_vect, __attribute__((weak))) {                                                                  // Watchdog interrupt, samples all encoders below the Timer2 rates
+  RotEncoderSampler::tick();
+}
+
+#else
+
+void RotEncoderSampler::watchdog(bool) { }                                                              // Not used, slowMode() never selects the watchdog
+
+#endif
+
+void RotEncoderSampler::sleep() {                                                                       // Sleep once in the deepest mode the sampling allows
+  cli();
+  set_sleep_mode(onWatchdog ? SLEEP_MODE_PWR_DOWN : SLEEP_MODE_IDLE);                                   // Timer2 needs the I/O clock, the watchdog does not
+  sleep_enable();
+  sei();                                                                                                // Interrupts enabled after next instruction, a switch to Timer2 wakes at once
+  sleep_cpu();
+  sleep_disable();
+}
+
+ISR(TIMER2_COMPA_vect) {                                                                                // Timer2 compare interrupt, samples all encoders
+  RotEncoderSampler::tick();
+}
+
+#else
+
+bool RotEncoderSampler::setRate(uint16_t hz) { rate = hz; return hz > 0; }                              // Rate of user timer calling tick(), for reference
+bool RotEncoderSampler::setLowPower(uint16_t) { return false; }                                         // Not available, pull-ups stay on
+void RotEncoderSampler::startTimer() { }                                                                // User calls tick() from own timer
+void RotEncoderSampler::stopTimer() { }
+void RotEncoderSampler::pullUp(RotEncoderSampled*, bool) { }                                            // Pins keep the pull-ups of begin()
+void RotEncoderSampler::adapt(bool) { }
+void RotEncoderSampler::watchdog(bool) { }
+void RotEncoderSampler::sleep() { }                                                                     // User timer, sleep mode is up to the sketch
+
+#endif
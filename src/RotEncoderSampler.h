@@ -0,0 +1,144 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderSampler.h                                                                                                       //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERSAMPLER_H
+#define ROTENCODERSAMPLER_H
+
+#include <Arduino.h>
+#include "RotEncoderDecoder.h"
+#include "RotEncoderCounter.h"
+
+// Timer sampled encoders, for pins without external interrupts:
+//
+//   RotEncoderSampledPins<PinA, PinB> can use any digital pins. The pins are sampled by a timer compare interrupt at a
+//   fixed rate (default ROTENCODER_SAMPLE_HZ = 2000 Hz, set with RotEncoderSampler::setRate() before begin()), and decoded
+//   by the table decoder. Encoders are sorted by port when registered, so all encoders that share a port are decoded from
+//   a single read of the port register. The CPU time per tick is bounded: at most ROTENCODER_MAX_SAMPLED encoders, each
+//   with a constant cost.
+//
+//   The sample rate must be high enough to see every state of the encoder, 2000 Hz is enough for hand turned knobs. The
+//   pull-ups are always on in this mode, as a pin must be an input to be sampled.
+//
+//   AVR: Timer2 in CTC mode (TIMER2_COMPA_vect), so tone() can not be used at the same time.
+//   Other targets: No timer is set up. Call RotEncoderSampler::tick() from your own timer interrupt at the sample rate.
+//
+// Low power sampling (classic AVR):
+//
+//   RotEncoderSampler::setLowPower(slowHz) drives all sampled pins low between samples, so no pull-up current flows, also
+//   with both switches closed. For each sample the pull-ups are turned on for ROTENCODER_SETTLE_US, the pins are read, and
+//   driven low again. The sample rate adapts: After ROTENCODER_IDLE_SAMPLES samples without a change of any pin the Timer2
+//   prescaler is raised one step, down to slowHz, and the first change goes back to the rate of setRate(). The decoder
+//   counts a step from both pins closed to one side, so a knob that starts to turn while sampled slowly loses at most the
+//   first step. The pull-up current is then about 2 * Vcc / Rpullup * ROTENCODER_SETTLE_US * rate, a few uA when idle.
+//
+//   Timer2 runs from the I/O clock, which only runs in SLEEP_MODE_IDLE, and its slowest rate is F_CPU / 1024 / top, about
+//   62 Hz for 2000 Hz at 16 MHz. A slowHz below that is sampled by the watchdog interrupt (16 ms * 2^n, 62.5 Hz down to
+//   0.12 Hz, the fastest watchdog rate at or above slowHz): When Timer2 is at its slowest and idle, it is stopped and the
+//   watchdog takes over, and the first change starts Timer2 again. The watchdog runs in SLEEP_MODE_PWR_DOWN, and
+//   RotEncoderSampler::sleep() sleeps in the deepest mode the sampling allows now. setLowPower() returns false if slowHz
+//   is above the rate, or between the slowest Timer2 rate and 62.5 Hz, or below it on MCUs without watchdog interrupt.
+//   The watchdog interrupt (WDT_vect) is a weak symbol, a sketch with its own WDT_vect must not use a slowHz below the
+//   Timer2 rates. Timer2 in asynchronous mode (SLEEP_MODE_PWR_SAVE) is not used, it needs a 32 kHz crystal on TOSC1 and
+//   TOSC2, which are the pins of the main crystal on Arduino Uno and Nano.
+
+#ifndef ROTENCODER_MAX_SAMPLED
+  #define ROTENCODER_MAX_SAMPLED 8                                                                      // Max. number of timer sampled encoders
+#endif
+#ifndef ROTENCODER_SAMPLE_HZ
+  #define ROTENCODER_SAMPLE_HZ 2000                                                                     // Default sample rate
+#endif
+#ifndef ROTENCODER_SETTLE_US
+  #define ROTENCODER_SETTLE_US 5                                                                        // Low power: Time from pull-up on to read, us
+#endif
+#ifndef ROTENCODER_IDLE_SAMPLES
+  #define ROTENCODER_IDLE_SAMPLES 32                                                                    // Low power: Samples without change before the rate is lowered
+#endif
+
+#if defined(__AVR__)
+typedef uint8_t RotEncoderPortT;                                                                        // Port register type
+#else
+typedef uint32_t RotEncoderPortT;
+#endif
+
+class RotEncoderSampled {                                                                               // Timer sampled encoder, pins set by begin()
+public:
+  long getPosition() const { return counter.get(); }                                                    // Returns rotary encoder position, lock-free
+  void setPosition(long pos) { counter.set(pos); }                                                      // Set position
+  void reset() { counter.set(0); }                                                                      // Set position to 0
+  long readAndResetDelta() { return counter.exchange(); }                                               // Returns steps since last call, and sets position to 0
+  bool end();                                                                                           // Stop rotary encoder, returns true if successful
+  ~RotEncoderSampled() { end(); }                                                                       // Destructor should call end() to safely remove from sampler
+
+protected:
+  bool begin(uint8_t pinA, uint8_t pinB);                                                               // Start rotary encoder, returns true if successful
+
+private:
+  friend class RotEncoderSampler;                                                                       // Sampler decodes the encoder
+  const volatile RotEncoderPortT* regA = nullptr;                                                       // Input register for PinA, nullptr if not started
+  const volatile RotEncoderPortT* regB = nullptr;                                                       // Input register for PinB
+  RotEncoderPortT maskA = 0, maskB = 0;                                                                 // Bitmasks in input registers
+  RotEncoderTableDecoder decoder;                                                                       // State machine, bounded time
+  RotEncoderCounter counter;                                                                            // Position
+  uint8_t pins = 0;                                                                                     // Pins of last sample, to detect movement
+};
+
+template <uint8_t PinA, uint8_t PinB>                                                                   // Timer sampled encoder on any pins
+class RotEncoderSampledPins : public RotEncoderSampled {
+public:
+  inline uint8_t getPinA() const __attribute__((always_inline)) { return PinA; }                        // Setup getPinA() to return with PinA from template
+  inline uint8_t getPinB() const __attribute__((always_inline)) { return PinB; }                        // Setup getPinB() to return with PinB from template
+  bool begin() { return RotEncoderSampled::begin(PinA, PinB); }                                         // Start rotary encoder, returns true if successful
+};
+
+class RotEncoderSampler {                                                                               // Timer that samples all registered encoders
+public:
+  static bool setRate(uint16_t hz);                                                                     // Set sample rate, returns false if not possible
+  static bool setLowPower(uint16_t slowHz);                                                             // Duty cycled pull-ups and adaptive rate down to slowHz, 0 = off, returns false if not possible
+  static bool tick();                                                                                   // Sample and decode all encoders, called from timer interrupt, returns true if a pin changed
+  static void sleep();                                                                                  // Sleep once, SLEEP_MODE_PWR_DOWN while the watchdog samples, SLEEP_MODE_IDLE otherwise
+
+private:
+  friend class RotEncoderSampled;
+  static bool add(RotEncoderSampled* e);                                                                // Register encoder, sorted by port
+  static bool remove(RotEncoderSampled* e);                                                             // Unregister encoder
+  static void startTimer();                                                                             // Start timer interrupt, first encoder
+  static void stopTimer();                                                                              // Stop timer interrupt, last encoder
+  static void pullUp(RotEncoderSampled* e, bool on);                                                    // Low power: Pull-ups of encoder on, or pins driven low
+  static void pullUps(bool on);                                                                         // Low power: Same for all encoders
+  static void adapt(bool moved);                                                                        // Low power: Adapt the sample rate after a sample
+  static void watchdog(bool on);                                                                        // Low power: Sample by watchdog instead of Timer2, or back
+  static RotEncoderSampled* list[ROTENCODER_MAX_SAMPLED];                                               // Registered encoders, sorted by port
+  static volatile uint8_t count;                                                                        // Number of registered encoders
+  static uint16_t rate;                                                                                 // Sample rate in Hz
+  static uint16_t slowRate;                                                                             // Low power: Lowest sample rate in Hz, 0 if low power is off
+  static uint8_t csFast, csSlow, cs;                                                                    // Low power: Timer2 prescaler at rate, at slowRate, and now
+  static uint8_t idle;                                                                                  // Low power: Samples without change at the current prescaler
+  static uint8_t wdt;                                                                                   // Low power: Watchdog prescaler below the Timer2 rates, noWatchdog if not used
+  static volatile bool onWatchdog;                                                                      // Low power: Watchdog samples now, Timer2 stopped
+};
+
+#endif  // ROTENCODERSAMPLER_H
@@ -0,0 +1,133 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderStats.h                                                                                                         //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERSTATS_H
+#define ROTENCODERSTATS_H
+
+#include <Arduino.h>
+#include "RotEncoderAtomic.h"  // Atomic blocks on all architectures
+
+// Interrupt handler statistics, opt-in at compile time:
+//
+//   #define ROTENCODER_STATS before the include of RotEncoder.h counts in each encoder the calls of intr(), the extra reads
+//   of the stable read loop (stableRead decoders), and the ignored transitions where a one-sided position is reached
+//   without a count (cntflg false, RotEncoderStdDecoder and RotEncoderTableDecoder). The time of each intr() is measured
+//   from a hardware counter, for the maximum and average time:
+//
+//   RotEncoderStatsData s = knob.getStats();                                                       // Consistent copy
+//   ... s.isr, s.retries, s.ignored, s.maxCycles, s.avgCycles() ...
+//
+//   The time is measured from the entry to the exit of intr(), and does not include the interrupt entry and exit of the
+//   vector. The counter is read by ROTENCODER_STATS_CYCLES(), which can be defined before the include to return another
+//   unsigned counter:
+//
+//     AVR:   TCNT1, CPU cycles if Timer1 runs in normal mode with prescaler 1, see RotEncoderStats::startCycleTimer().
+//            If Timer1 is used by other code (e.g. PWM), define ROTENCODER_STATS_CYCLES() to read a free running counter.
+//     ARM:   DWT cycle counter (Cortex-M3 and up), enabled by startCycleTimer().
+//     Other: micros(), the time is in us.
+//
+//   Without ROTENCODER_STATS the statistics are an empty base class of the encoder, with no storage and no code.
+//
+//   RotEncoder and RotEncoderPins have no statistics: Their core is compiled once in RotEncoder.cpp, without the defines of
+//   the sketch, so they always use RotEncoderNoStats and have the same layout in all files. Use RotEncoderPinsT or another
+//   RotEncoderT based class for statistics.
+
+struct RotEncoderStatsData {                                                                            // Statistics of intr()
+  uint32_t isr = 0;                                                                                     // Calls of intr()
+  uint32_t retries = 0;                                                                                 // Extra reads of the stable read loop
+  uint32_t ignored = 0;                                                                                 // One-sided positions without count (cntflg false)
+  uint32_t maxCycles = 0;                                                                               // Longest intr()
+  uint32_t sumCycles = 0;                                                                               // Sum of all intr(), for average
+  uint32_t avgCycles() const { return isr ? (sumCycles / isr) : 0; }                                    // Average intr()
+};
+
+class RotEncoderNoStats {                                                                               // Statistics disabled, no storage and no code
+protected:
+  typedef uint8_t CyclesT;
+  inline CyclesT statsStart() __attribute__((always_inline)) { return 0; }
+  inline void statsRetry() __attribute__((always_inline)) { }
+  inline void statsIgnored() __attribute__((always_inline)) { }
+  inline void statsEnd(CyclesT) __attribute__((always_inline)) { }
+};
+
+#ifdef ROTENCODER_STATS
+
+#ifndef ROTENCODER_STATS_CYCLES                                                                         // Cycle counter, can be defined before include
+  #if defined(__AVR__) && defined(TCNT1)
+    #define ROTENCODER_STATS_CYCLES() ((uint16_t)TCNT1)                                                 //   Timer1, 16-bit
+  #elif defined(__arm__) && defined(DWT)
+    #define ROTENCODER_STATS_CYCLES() ((uint32_t)DWT->CYCCNT)                                           //   DWT cycle counter, 32-bit
+  #else
+    #define ROTENCODER_STATS_CYCLES() micros()                                                          //   Time in us
+  #endif
+#endif
+
+class RotEncoderStats {                                                                                 // Statistics of intr(), base class of the encoder
+public:
+  RotEncoderStatsData getStats() const {                                                                // Returns copy of statistics, from the same instant
+    RotEncoderStatsData s;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { s = data; }
+    return s;
+  }
+  void resetStats() {                                                                                   // Clears statistics
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { data = RotEncoderStatsData(); }
+  }
+
+  static void startCycleTimer() {                                                                       // Starts the default cycle counter
+#if defined(__AVR__) && defined(TCNT1)
+    TCCR1A = 0;                                                                                         // Timer1 normal mode, prescaler 1
+    TCCR1B = _BV(CS10);
+#elif defined(__arm__) && defined(DWT)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;                                                     // Enable trace, and the DWT cycle counter
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+  }
+
+protected:
+  typedef decltype(ROTENCODER_STATS_CYCLES()) CyclesT;                                                  // Type of cycle counter
+  inline CyclesT statsStart() __attribute__((always_inline)) { return ROTENCODER_STATS_CYCLES(); }      // Entry of intr(), returns start time
+  inline void statsRetry() __attribute__((always_inline)) { data.retries++; }                           // Extra read of the stable read loop
+  inline void statsIgnored() __attribute__((always_inline)) { data.ignored++; }                         // One-sided position without count
+  inline void statsEnd(CyclesT start) __attribute__((always_inline)) {                                  // Exit of intr()
+    uint32_t t = (CyclesT)(ROTENCODER_STATS_CYCLES() - start);                                          // Wraps in the width of the counter
+    data.isr++;
+    data.sumCycles += t;
+    if (t > data.maxCycles) data.maxCycles = t;
+  }
+
+private:
+  RotEncoderStatsData data;                                                                             // Updated in intr()
+};
+
+#else
+
+typedef RotEncoderNoStats RotEncoderStats;                                                              // Statistics disabled
+
+#endif
+
+#endif  // ROTENCODERSTATS_H
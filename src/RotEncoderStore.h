@@ -0,0 +1,142 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderStore.h                                                                                                         //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERSTORE_H
+#define ROTENCODERSTORE_H
+
+#include <Arduino.h>
+
+// Position stored in EEPROM, restored after power on (AVR):
+//
+//   RotEncoderStore<Slots, Addr, T> writes the position to a ring of Slots records in EEPROM from address Addr. Each record
+//   is a sequence number, the position and a CRC-8, and each save writes the next record, so each byte is written once per
+//   Slots saves (wear leveling). restore() scans the ring once and returns the position of the newest record with a valid
+//   CRC. A record cut by a power loss has a wrong CRC, and the record before it is used.
+//
+//   RotEncoderStore<8> store;                                                                      // 8 records from address 0
+//
+//   void setup() {
+//     knob.begin();
+//     knob.setPosition(store.restore());                                                           // Last saved position, or 0
+//   }
+//   void loop() {
+//     store.update(knob.getPosition());                                                            // Saves when idle, never blocks
+//   }
+//
+//   update() is called from the main loop, never from intr(). A changed position is saved when it has not changed for
+//   setIdle() ms (default ROTENCODER_STORE_IDLE_MS). The record is written one byte per update(), and only when the
+//   EEPROM is ready, so update() never waits for the 3.3 ms write time of a byte. Unchanged bytes are not written.
+
+#if defined(__AVR__)
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+
+#ifndef ROTENCODER_STORE_IDLE_MS
+  #define ROTENCODER_STORE_IDLE_MS 2000                                                                 // Time without change before the position is saved
+#endif
+
+template <uint8_t Slots = 8, uint16_t Addr = 0, class T = long>
+class RotEncoderStore {                                                                                 // Position in EEPROM, wear leveled
+public:
+  static constexpr uint8_t recordSize = sizeof(T) + 2;                                                  // Sequence number, position and CRC
+  static_assert((Slots >= 2) && (Slots < 128), "RotEncoderStore: Slots must be 2..127");
+  static_assert(Addr + (uint32_t)Slots * recordSize <= E2END + 1UL, "RotEncoderStore: Records do not fit in EEPROM");
+
+  T restore();                                                                                          // Returns newest saved position, or 0 if none
+  void update(T pos);                                                                                   // Main loop: Saves pos when idle, one byte per call
+  bool busy() const { return wr < recordSize; }                                                         // True while a record is written
+  void setIdle(uint16_t ms) { idleMs = ms; }                                                            // Time without change before save
+
+private:
+  static uint8_t crc(const uint8_t* p) {                                                                // CRC-8 of sequence number and position
+    uint8_t c = 0xFF;
+    for (uint8_t i = 0; i < recordSize - 1; i++) c = _crc8_ccitt_update(c, p[i]);
+    return c;
+  }
+  static uint16_t addr(uint8_t slot) { return Addr + (uint16_t)slot * recordSize; }                     // EEPROM address of record
+
+  uint8_t buf[recordSize];                                                                              // Record being written
+  uint8_t wr = recordSize;                                                                              // Next byte of buf to write, recordSize if none
+  uint8_t slot = 0;                                                                                     // Next record to write
+  uint8_t seq = 0;                                                                                      // Sequence number of next record
+  uint16_t idleMs = ROTENCODER_STORE_IDLE_MS;
+  T saved = 0;                                                                                          // Position in newest record
+  T pending = 0;                                                                                        // Position at last change
+  uint32_t changed = 0;                                                                                 // millis() at last change
+};
+
+template <uint8_t Slots, uint16_t Addr, class T>
+T RotEncoderStore<Slots, Addr, T>::restore() {                                                          // Scan ring once, newest valid record
+  int8_t last = -1;
+  uint8_t r[recordSize];
+  for (uint8_t i = 0; i < Slots; i++) {
+    eeprom_read_block(r, (const void*)addr(i), recordSize);
+    if (crc(r) != r[recordSize - 1]) continue;                                                          // Never written, or cut by power loss
+    if ((last < 0) || ((int8_t)(r[0] - seq) > 0)) {                                                     // Newer than newest so far, all are within Slots saves
+      last = i;
+      seq = r[0];
+      memcpy(&saved, r + 1, sizeof(T));
+    }
+  }
+  if (last < 0) {                                                                                       // Nothing saved: Start at first record
+    slot = 0; seq = 0; saved = 0;
+  } else {
+    slot = (last + 1) % Slots;                                                                          // Next record after newest
+    seq++;
+  }
+  pending = saved;
+  wr = recordSize;
+  return saved;
+}
+
+template <uint8_t Slots, uint16_t Addr, class T>
+void RotEncoderStore<Slots, Addr, T>::update(T pos) {                                                   // Main loop: Saves pos when idle, never blocks
+  if (wr < recordSize) {                                                                                // Writing a record:
+    if (!eeprom_is_ready()) return;                                                                     //   Last byte still being written
+    eeprom_update_byte((uint8_t*)addr(slot) + wr, buf[wr]);                                             //   Starts write, CRC is written last
+    if (++wr == recordSize) {                                                                           //   Record complete
+      memcpy(&saved, buf + 1, sizeof(T));
+      slot = (slot + 1) % Slots;
+      seq++;
+    }
+    return;
+  }
+  uint32_t now = millis();
+  if (pos != pending) {                                                                                 // Moved: Wait until idle
+    pending = pos;
+    changed = now;
+  } else if ((pos != saved) && (now - changed >= idleMs)) {                                             // Idle and not saved: Start record
+    buf[0] = seq;
+    memcpy(buf + 1, &pos, sizeof(T));
+    buf[recordSize - 1] = crc(buf);
+    wr = 0;
+  }
+}
+
+#endif
+
+#endif  // ROTENCODERSTORE_H
@@ -0,0 +1,128 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderVelocity.h                                                                                                      //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERVELOCITY_H
+#define ROTENCODERVELOCITY_H
+
+#include <Arduino.h>
+#include "RotEncoderClock.h"
+
+// Velocity and acceleration from step timestamps:
+//
+//   The interrupt handler calls step() after each counted step, which stores a RotEncoderClock::now32() timestamp in a ring
+//   of the last N steps. This is a timer read and a store, there is no division in the interrupt handler. A change of
+//   direction restarts the ring, so the intervals always belong to one direction.
+//
+//   The velocity is computed lazily in the main loop when it is read:
+//
+//     getVelocity()         Steps per second from the last interval, fast response.
+//     getSmoothVelocity()   Steps per second from the mean of the last N-1 intervals.
+//     getAcceleration()     Steps per second^2 from the last two intervals.
+//
+//   While the knob is not moving, the time since the last step is used as the interval when it is longer than the measured
+//   interval, so the velocity decays smoothly. After the timeout (default 250 ms), all values are 0. Positive values are
+//   counting up and negative values counting down.
+//
+//   class Knob : public RotEncoderPinsT<2, 3, RotEncoderStdDecoder, Knob> {
+//   public:
+//     RotEncoderVelocity<8> velocity;
+//     void onStep(int8_t dir) { velocity.step(dir); }                                                // Hook called by intr()
+//   };
+
+template <uint8_t N = 8>
+class RotEncoderVelocity {                                                                              // Velocity from the last N step timestamps
+  static_assert((N >= 4) && (N <= 64) && ((N & (N - 1)) == 0), "RotEncoderVelocity: N must be a power of 2, 4 to 64");
+
+public:
+  inline void step(int8_t dir) __attribute__((always_inline)) {                                         // Interrupt handler: Store timestamp for step
+    uint32_t t = RotEncoderClock::now32();                                                              // Timer read
+    if (dir != lastDir) {                                                                               // Direction changed:
+      lastDir = dir;                                                                                    //   Restart ring
+      count = 0;
+    }
+    times[idx] = t;
+    idx = (idx + 1) & (N - 1);
+    if (count < N) count++;
+    seq++;                                                                                              // Tell readers ring changed
+  }
+
+  void setTimeout(uint16_t ms) { timeout = ms; }                                                        // Velocity is 0 if no step for ms milliseconds
+  float getVelocity() const { return velocity(2); }                                                     // Steps/s from last interval
+  float getSmoothVelocity() const { return velocity(N); }                                               // Steps/s from last N-1 intervals
+
+  float getAcceleration() const {                                                                       // Steps/s^2 from last two intervals
+    int8_t dir; uint8_t n;
+    uint32_t t[3];
+    read(dir, n, t, 3);
+    if (n < 3) return 0;                                                                                // Need two intervals
+    uint32_t now = RotEncoderClock::read32();
+    if (expired(now - t[0])) return 0;
+    float i1 = t[1] - t[2];                                                                             // Previous interval
+    float i0 = t[0] - t[1];                                                                             // Last interval
+    if ((now - t[0]) > i0) i0 = now - t[0];                                                             // Still waiting, interval is at least this long
+    float tps = RotEncoderClock::ticksPerSecond;
+    return dir * (tps / i0 - tps / i1) * 2 * tps / (i0 + i1);                                           // Change of velocity over mean interval
+  }
+
+private:
+  uint32_t times[N];                                                                                    // Timestamps of last steps
+  volatile uint8_t idx = 0;                                                                             // Next slot to write
+  volatile uint8_t count = 0;                                                                           // Number of valid timestamps
+  volatile int8_t lastDir = 0;                                                                          // Direction of steps in ring
+  volatile uint8_t seq = 0;                                                                             // Sequence counter, changed by every step()
+  uint16_t timeout = 250;                                                                               // Timeout in ms
+
+  void read(int8_t& dir, uint8_t& n, uint32_t* t, uint8_t max) const {                                  // Consistent copy of newest timestamps, t[0] is newest
+    uint8_t s;
+    do {
+      s = seq;
+      asm volatile("" ::: "memory");                                                                    // Compiler barrier, read timestamps after seq
+      dir = lastDir; n = count; uint8_t i = idx;
+      if (n > max) n = max;
+      for (uint8_t k = 0; k < n; k++) t[k] = times[(uint8_t)(i - 1 - k) & (N - 1)];
+      asm volatile("" ::: "memory");                                                                    // Compiler barrier, timestamps are read before seq is checked
+    } while (s != seq);                                                                                 // Retry if step() was called during copy
+  }
+
+  bool expired(uint32_t elapsed) const {                                                                // True if no step within timeout
+    return elapsed > (uint32_t)timeout * (RotEncoderClock::ticksPerSecond / 1000);
+  }
+
+  float velocity(uint8_t max) const {                                                                   // Steps/s over up to max timestamps
+    int8_t dir; uint8_t n;
+    uint32_t t[N];
+    read(dir, n, t, max);
+    if (n < 2) return 0;                                                                                // Need one interval
+    uint32_t elapsed = RotEncoderClock::read32() - t[0];
+    if (expired(elapsed)) return 0;
+    uint32_t span = t[0] - t[n - 1];                                                                    // Time for n-1 intervals
+    if (elapsed * (n - 1) > span) span = elapsed * (n - 1);                                             // Still waiting, decay velocity
+    return dir * (float)(n - 1) * RotEncoderClock::ticksPerSecond / span;
+  }
+};
+
+#endif  // ROTENCODERVELOCITY_H
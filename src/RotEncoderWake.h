@@ -0,0 +1,99 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                                                      //
+//  Arduino Rotary Encoder Library                                                                                                      //
+//  Copyright (C) 2019-2024 Jens Dyekjær Madsen                                                                                         //
+//                                                                                                                                      //
+//  Filename: RotEncoderWake.h                                                                                                          //
+//                                                                                                                                      //
+//  Description:                                                                                                                        //
+//  Fast and precise rotary encoder library with low power consumption, optimized for high-speed and battery-powered applications.      //
+//                                                                                                                                      //
+//  This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License    //
+//  as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.             //
+//                                                                                                                                      //
+//  This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of      //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.                   //
+//  You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to the              //
+//  Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA                                            //
+//                                                                                                                                      //
+//  It is not allowed to change any license or copyright statements, but feel free to modify, change, and add your own copyrights       //
+//  below this line only !                                                                                                              //
+//  ----------------------------------------------------------------------------------------------------------------------------------  //
+//                                                                                                                                      //
+//  Testet on AVR architecture: Arduino Nano.                                                                                           //
+//                                                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROTENCODERWAKE_H
+#define ROTENCODERWAKE_H
+
+#include <Arduino.h>
+#if defined(__AVR__)
+  #include <avr/sleep.h>
+#endif
+
+// Wake the main loop when an encoder moves:
+//
+//   RotEncoderWake::notify() sets a flag, and is called from the onStep() hook of an encoder. sleep() puts the MCU to
+//   sleep until the flag is set, and without race: If a step comes between the test of the flag and the sleep instruction,
+//   the MCU does not go to sleep (AVR: sei is always followed by one more instruction, ARM: WFI also wakes on an interrupt
+//   that is pending while interrupts are disabled).
+//
+//   class Knob : public RotEncoderPinsT<2, 3, RotEncoderStdDecoder, Knob> {
+//   public:
+//     void onStep(int8_t) { RotEncoderWake::notify(); }                                              // Zero cost if not used
+//   };
+//
+//   void loop() {
+//     RotEncoderWake::sleep();                                                                       // Sleep until the knob is turned
+//     ... knob.getPosition() ...
+//   }
+//
+//   AVR: The external interrupts (INT0, INT1) detect a CHANGE edge only while the I/O clock runs, so the default sleep mode
+//   is SLEEP_MODE_IDLE. Pin change interrupts (RotEncoderPcint) also wake the MCU from SLEEP_MODE_PWR_DOWN.
+
+class RotEncoderWake {                                                                                  // Flag set by encoder steps, and sleep until set
+public:
+  static inline void notify() __attribute__((always_inline)) { flag = true; }                           // Interrupt handler: Encoder moved
+
+  static bool changed() {                                                                               // Main loop: True if moved since last call, clears flag
+    if (!flag) return false;                                                                            // Fast path, single byte read
+    flag = false;                                                                                       // Clear before reading the encoder, so a new step sets it again
+    return true;
+  }
+
+#if defined(__AVR__)
+  static void sleep(uint8_t mode = SLEEP_MODE_IDLE) {                                                   // Sleep until moved, clears flag
+    set_sleep_mode(mode);
+    while (true) {
+      cli();
+      if (flag) break;                                                                                  // Moved, interrupts are enabled below
+      sleep_enable();
+      sei();                                                                                            // Interrupts enabled after next instruction, no step is missed
+      sleep_cpu();
+      sleep_disable();                                                                                  // Other interrupts (e.g. millis() timer) wake too, sleep again
+    }
+    sei();
+    flag = false;
+  }
+#elif defined(__arm__)
+  static void sleep() {                                                                                 // Sleep until moved, clears flag
+    while (true) {
+      __disable_irq();
+      bool f = flag;
+      if (!f) __WFI();                                                                                  // Wakes on pending interrupt, also with interrupts disabled
+      __enable_irq();                                                                                   // Runs pending interrupt handlers
+      if (f || flag) break;                                                                             // Other interrupts wake too, sleep again
+    }
+    flag = false;
+  }
+#else
+  static void sleep() { while (!flag) { } flag = false; }                                               // No sleep, wait for flag
+#endif
+
+private:
+  static volatile bool flag;                                                                            // Set when encoder moved, defined in RotEncoder.cpp
+};
+
+#endif  // ROTENCODERWAKE_H